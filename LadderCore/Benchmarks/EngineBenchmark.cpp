@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    EngineBenchmark.cpp
+
+    Cost per stereo frame of the whole LadderEngine chain while static and
+    while the drive is being moved, and of LadderKernel on its own with a
+    static and a modulated cutoff, for each instruction set CpuDispatch can
+    use on this machine. Then the static engine again on the picked set,
+    fed by a host that splits the same audio into very small blocks, with
+    the cost over 512-sample blocks.
+
+  ==============================================================================
+*/
+
+#include "LadderEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 4000;
+
+    template <typename Function>
+    double timePerFrame(Function&& processBlock)
+    {
+        std::vector<float> left (blockSize), right (blockSize);
+        std::mt19937 random (1);
+        std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+
+        for (int i = 0; i < blockSize; i++)
+            left[(size_t) i] = right[(size_t) i] = noise(random);
+
+        float* channels[] = { left.data(), right.data() };
+
+        //warm up, then time
+        for (int block = 0; block < numBlocks / 10; block++)
+            processBlock(channels, block);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int block = 0; block < numBlocks; block++)
+            processBlock(channels, block);
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / ((double) numBlocks * blockSize);
+    }
+}
+
+int main()
+{
+    std::printf("ns per stereo frame at %d samples per block\n", blockSize);
+    std::printf("           engine static   drive ramping   kernel static   kernel modulated\n");
+
+    for (auto instructionSet : CpuDispatch::allInstructionSets) {
+        if (! CpuDispatch::force(instructionSet))
+            continue;
+
+        LadderEngine engine;
+        engine.prepare(sampleRate, 2);
+        engine.setParameter(LadderEngine::Parameter::drive, 4.0f);
+        engine.setParameter(LadderEngine::Parameter::cutoff, 1200.0f);
+        engine.setParameter(LadderEngine::Parameter::resonance, 0.6f);
+        engine.reset();
+
+        const auto engineStatic = timePerFrame([&] (float* const* channels, int) { engine.process(channels, 2, blockSize); });
+
+        //a new drive every block keeps the gain ramps running
+        const auto engineMoving = timePerFrame([&] (float* const* channels, int block) {
+            engine.setParameter(LadderEngine::Parameter::drive, 2.0f + (float) (block % 2));
+            engine.process(channels, 2, blockSize);
+        });
+
+        LadderKernel kernel;
+        kernel.prepare(sampleRate, 2);
+        kernel.setDrive(1.0f);
+        kernel.setCutoffFrequencyHz(1200.0f);
+        kernel.setResonance(0.6f);
+        kernel.reset();
+
+        std::vector<float> octaves (blockSize);
+
+        for (int i = 0; i < blockSize; i++)
+            octaves[(size_t) i] = (float) std::sin(6.283185307 * i / blockSize);
+
+        const auto kernelStatic = timePerFrame([&] (float* const* channels, int) { kernel.process(channels, 2, blockSize); });
+        const auto kernelModulated = timePerFrame([&] (float* const* channels, int) { kernel.processModulated(channels, 2, blockSize, octaves.data()); });
+
+        std::printf("  %-8s %12.1f %15.1f %15.1f %18.1f\n", CpuDispatch::getName(instructionSet),
+                    engineStatic, engineMoving, kernelStatic, kernelModulated);
+        }
+
+    CpuDispatch::clearForced();
+    std::printf("picked at run time: %s\n", CpuDispatch::getName(CpuDispatch::getActive()));
+
+    LadderEngine engine;
+    engine.prepare(sampleRate, 2);
+    engine.setParameter(LadderEngine::Parameter::drive, 4.0f);
+    engine.setParameter(LadderEngine::Parameter::cutoff, 1200.0f);
+    engine.setParameter(LadderEngine::Parameter::resonance, 0.6f);
+    engine.reset();
+
+    const auto timeHostBlocks = [&engine] (int hostBlockSize) {
+        return timePerFrame([&] (float* const* channels, int) {
+            for (int offset = 0; offset < blockSize; offset += hostBlockSize) {
+                float* hostChannels[] = { channels[0] + offset, channels[1] + offset };
+                engine.process(hostChannels, 2, std::min(hostBlockSize, blockSize - offset));
+                }
+        });
+    };
+
+    const auto wholeBlocks = timeHostBlocks(blockSize);
+    std::printf("\nhost block   ns per stereo frame   over %d (%.1f)\n", blockSize, wholeBlocks);
+
+    for (int hostBlockSize : { 1, 2, 4, 8, 16 }) {
+        const auto perFrame = timeHostBlocks(hostBlockSize);
+        std::printf("  %8d %21.1f %8.0f%%\n", hostBlockSize, perFrame, (perFrame / wholeBlocks - 1.0) * 100.0);
+        }
+
+    return 0;
+}
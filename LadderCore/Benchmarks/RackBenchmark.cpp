@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    RackBenchmark.cpp
+
+    Times the rack's lane-parallel chains against the same number of single
+    plugin chains run one after another, the way separate instances would
+    (table saturation, LadderKernel and trim per instance). Host and plugin
+    wrapper overhead per instance comes on top of the separate chains, so
+    this is the rack's smallest possible advantage. Only the DSP chains are
+    compared, neither side is a real plugin instance; RackInstanceBenchmark
+    in LadderFilter/Tests runs the plugins themselves.
+
+  ==============================================================================
+*/
+
+#include "LadderLanes.h"
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 4000;
+
+    //one plugin instance's static path, as in LadderFilterAudioProcessor::processSegment
+    struct Instance
+    {
+        Instance(std::shared_ptr<const SaturationTable> table, float drive, float cutoff)
+            : saturation(std::move(table))
+        {
+            ladder.prepare(sampleRate, 2);
+            ladder.setDrive(1.0f);
+            ladder.setCutoffFrequencyHz(cutoff);
+            ladder.setResonance(0.5f);
+            ladder.reset();
+
+            inputGain = std::pow(10.0f, drive * 5.0f * 0.05f);
+            outputGain = 0.63661977236f * 1.5f * std::pow(10.0f, -drive * 5.0f * 0.04f);
+        }
+
+        void process(float* const* channels, int numSamples)
+        {
+            for (int channel = 0; channel < 2; channel++)
+                for (int i = 0; i < numSamples; i++)
+                    channels[channel][i] = saturation->atan(inputGain * channels[channel][i]) * outputGain;
+
+            ladder.process(channels, 2, numSamples);
+
+            for (int channel = 0; channel < 2; channel++)
+                for (int i = 0; i < numSamples; i++)
+                    channels[channel][i] *= trimGain;
+        }
+
+        std::shared_ptr<const SaturationTable> saturation;
+        LadderKernel ladder;
+        float inputGain = 1.0f, outputGain = 1.0f, trimGain = 1.0f;
+    };
+
+    template <typename Function>
+    double timePerFrame(Function&& processBlock)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int block = 0; block < numBlocks; block++)
+            processBlock();
+
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / ((double) numBlocks * blockSize);
+    }
+
+    template <int numChains>
+    void run(std::shared_ptr<const SaturationTable> saturation)
+    {
+        using Lanes = LadderLanes<numChains * 2>;
+
+        std::vector<std::vector<float>> audio (numChains * 2, std::vector<float> (blockSize));
+
+        for (size_t channel = 0; channel < audio.size(); channel++)
+            for (int i = 0; i < blockSize; i++)
+                audio[channel][(size_t) i] = 0.5f * std::sin(0.01f * (float) (i * (channel + 1)));
+
+        const auto input = audio;
+
+        //separate chains, one per instance
+        std::vector<std::unique_ptr<Instance>> instances;
+
+        for (int chain = 0; chain < numChains; chain++)
+            instances.push_back(std::make_unique<Instance>(saturation, 0.2f * (float) chain, 200.0f * (float) (chain + 1)));
+
+        const auto separate = timePerFrame([&] {
+            audio = input;
+
+            for (int chain = 0; chain < numChains; chain++) {
+                float* channels[] = { audio[(size_t) chain * 2].data(), audio[(size_t) chain * 2 + 1].data() };
+                instances[(size_t) chain]->process(channels, blockSize);
+            }
+        });
+
+        //the rack, gathering into lane frames and scattering back as RackProcessor does
+        Lanes lanes;
+        lanes.prepare(sampleRate);
+
+        for (int chain = 0; chain < numChains; chain++)
+            for (int channel = 0; channel < 2; channel++)
+                lanes.setLane(channel * numChains + chain, { 0.2f * (float) chain, 200.0f * (float) (chain + 1), 0.5f, 0.0f, LadderKernel::Mode::LPF12 });
+
+        lanes.reset();
+        std::vector<float> frames ((size_t) blockSize * Lanes::lanes);
+
+        const auto rack = timePerFrame([&] {
+            audio = input;
+
+            for (size_t lane = 0; lane < (size_t) Lanes::lanes; lane++) {
+                const auto& channel = audio[(lane % numChains) * 2 + lane / numChains];
+
+                for (int i = 0; i < blockSize; i++)
+                    frames[(size_t) i * Lanes::lanes + lane] = channel[(size_t) i];
+            }
+
+            lanes.process(frames.data(), blockSize);
+
+            for (size_t lane = 0; lane < (size_t) Lanes::lanes; lane++) {
+                auto& channel = audio[(lane % numChains) * 2 + lane / numChains];
+
+                for (int i = 0; i < blockSize; i++)
+                    channel[(size_t) i] = frames[(size_t) i * Lanes::lanes + lane];
+            }
+        });
+
+        std::printf("%2d stereo chains: separate %7.1f ns/frame, rack %7.1f ns/frame, %.2fx faster\n",
+                    numChains, separate, rack, separate / rack);
+    }
+}
+
+int main()
+{
+    auto saturation = SharedTables::getSaturation();
+
+    run<4>(saturation);
+    run<8>(saturation);
+    run<16>(saturation);
+    return 0;
+}
@@ -0,0 +1,370 @@
+/*
+  ==============================================================================
+
+    LadderCoreModule.cpp
+
+    Python bindings for LadderEngine, as the ladder_core module. Audio comes
+    in as any writable, C-contiguous buffer of shape (channels, samples) or
+    (samples,), such as a NumPy array, and is processed in place through
+    the buffer protocol. float32 is processed where it lies. float64 goes
+    through a small float32 scratch a chunk at a time, never as a copy of
+    the whole array. The GIL is released while the engine runs, so
+    separate Filters can process on separate threads.
+
+    Automation arrays hold one value per sample for drive, cutoff,
+    resonance or trim. They are read every automationInterval samples,
+    like a host handing over parameter changes, and smoothed as in the
+    plugin.
+
+  ==============================================================================
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "../Source/LadderEngine.h"
+#include <cstring>
+
+namespace
+{
+    constexpr int automationInterval = 32;
+    constexpr int scratchSize = 256;
+    constexpr int maxBlockSize = 1 << 20;
+    constexpr int maxChannels = 64;
+
+    const char* const parameterNames[] = { "drive", "cutoff", "resonance", "trim", "mode" };
+
+    //a buffer we can read floats or doubles out of, released with the object
+    struct Buffer
+    {
+        Py_buffer view {};
+        bool held = false;
+        bool isDouble = false;
+
+        ~Buffer() { if (held) PyBuffer_Release(&view); }
+
+        bool acquire(PyObject* object, bool writable, const char* name)
+        {
+            const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+
+            if (PyObject_GetBuffer(object, &view, flags) != 0)
+                return false;
+
+            held = true;
+
+            //skip byte order and size markers, only native floats are accepted
+            const char* format = view.format != nullptr ? view.format : "B";
+
+            if (*format == '@' || *format == '=' || *format == '<')
+                ++format;
+
+            if (std::strcmp(format, "f") == 0 && view.itemsize == 4) {
+                isDouble = false;
+                }
+            else if (std::strcmp(format, "d") == 0 && view.itemsize == 8) {
+                isDouble = true;
+                }
+            else {
+                PyErr_Format(PyExc_TypeError, "%s must hold float32 or float64 values", name);
+                return false;
+                }
+
+            return true;
+        }
+
+        float get(Py_ssize_t index) const noexcept
+        {
+            return isDouble ? (float) static_cast<const double*>(view.buf)[index]
+                            : static_cast<const float*>(view.buf)[index];
+        }
+    };
+
+    struct Filter
+    {
+        PyObject_HEAD
+        LadderEngine* engine;
+        int numChannels;
+        double sampleRate;
+        bool busy;
+        std::vector<float>* scratch;
+    };
+
+    int Filter_init(Filter* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* keywords[] = { "sample_rate", "channels", nullptr };
+        double sampleRate = 0.0;
+        int channels = 2;
+
+        if (! PyArg_ParseTupleAndKeywords(args, kwargs, "d|i", const_cast<char**>(keywords), &sampleRate, &channels))
+            return -1;
+
+        if (! (sampleRate > 0.0) || std::isinf(sampleRate) || channels <= 0 || channels > maxChannels) {
+            PyErr_SetString(PyExc_ValueError, "sample_rate must be positive and finite, and channels between 1 and 64");
+            return -1;
+            }
+
+        if (self->busy) {
+            PyErr_SetString(PyExc_RuntimeError, "Filter is processing on another thread");
+            return -1;
+            }
+
+        try {
+            if (self->engine == nullptr)
+                self->engine = new LadderEngine();
+
+            if (self->scratch == nullptr)
+                self->scratch = new std::vector<float>();
+
+            self->engine->prepare(sampleRate, channels);
+            self->scratch->assign((size_t) channels * scratchSize, 0.0f);
+            }
+        catch (const std::bad_alloc&) {
+            PyErr_NoMemory();
+            return -1;
+            }
+
+        self->numChannels = channels;
+        self->sampleRate = sampleRate;
+        return 0;
+    }
+
+    void Filter_dealloc(Filter* self)
+    {
+        delete self->engine;
+        delete self->scratch;
+        Py_TYPE(self)->tp_free((PyObject*) self);
+    }
+
+    bool checkReady(Filter* self)
+    {
+        if (self->engine == nullptr) {
+            PyErr_SetString(PyExc_RuntimeError, "Filter.__init__ was not called");
+            return false;
+            }
+
+        if (self->busy) {
+            PyErr_SetString(PyExc_RuntimeError, "Filter is processing on another thread");
+            return false;
+            }
+
+        return true;
+    }
+
+    //runs numSamples of float32 channels, with automation applied every automationInterval samples
+    void run(LadderEngine& engine, float* const* channels, int numChannels, Py_ssize_t offset, int numSamples,
+             const Buffer* const* automation) noexcept
+    {
+        for (int start = 0; start < numSamples; start += automationInterval) {
+            const auto count = std::min(automationInterval, numSamples - start);
+
+            for (int parameter = 0; parameter < 4; parameter++)
+                if (automation[parameter] != nullptr)
+                    engine.setParameter((LadderEngine::Parameter) parameter, automation[parameter]->get(offset + start));
+
+            float* pointers[maxChannels];
+
+            for (int channel = 0; channel < numChannels; channel++)
+                pointers[channel] = channels[channel] + start;
+
+            engine.process(pointers, numChannels, count);
+            }
+    }
+
+    PyObject* Filter_process(Filter* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* keywords[] = { "audio", "drive", "cutoff", "resonance", "trim", nullptr };
+        PyObject* audioObject = nullptr;
+        PyObject* automationObjects[4] = { Py_None, Py_None, Py_None, Py_None };
+
+        if (! PyArg_ParseTupleAndKeywords(args, kwargs, "O|OOOO", const_cast<char**>(keywords), &audioObject,
+                                          &automationObjects[0], &automationObjects[1], &automationObjects[2], &automationObjects[3]))
+            return nullptr;
+
+        if (! checkReady(self))
+            return nullptr;
+
+        Buffer audio;
+
+        if (! audio.acquire(audioObject, true, "audio"))
+            return nullptr;
+
+        if (audio.view.ndim != 1 && audio.view.ndim != 2) {
+            PyErr_SetString(PyExc_ValueError, "audio must have shape (channels, samples) or (samples,)");
+            return nullptr;
+            }
+
+        const auto numChannels = audio.view.ndim == 2 ? audio.view.shape[0] : 1;
+        const auto numSamples = audio.view.shape[audio.view.ndim - 1];
+
+        if (numChannels > self->numChannels || numChannels > maxChannels) {
+            PyErr_Format(PyExc_ValueError, "audio has %zd channels, the filter was made for %d", numChannels, self->numChannels);
+            return nullptr;
+            }
+
+        Buffer automationBuffers[4];
+        const Buffer* automation[4] = {};
+
+        for (int parameter = 0; parameter < 4; parameter++) {
+            if (automationObjects[parameter] == Py_None)
+                continue;
+
+            auto& buffer = automationBuffers[parameter];
+
+            if (! buffer.acquire(automationObjects[parameter], false, parameterNames[parameter]))
+                return nullptr;
+
+            if (buffer.view.ndim != 1 || buffer.view.shape[0] != numSamples) {
+                PyErr_Format(PyExc_ValueError, "%s automation must have one value per sample", parameterNames[parameter]);
+                return nullptr;
+                }
+
+            automation[parameter] = &buffer;
+            }
+
+        auto& engine = *self->engine;
+        const auto channelCount = (int) numChannels;
+        self->busy = true;
+
+        Py_BEGIN_ALLOW_THREADS
+
+        if (! audio.isDouble) {
+            auto* data = static_cast<float*>(audio.view.buf);
+            float* channels[maxChannels];
+
+            //the engine counts samples in ints, so very long arrays go through in blocks
+            for (Py_ssize_t offset = 0; offset < numSamples; offset += maxBlockSize) {
+                const auto count = (int) std::min<Py_ssize_t>(maxBlockSize, numSamples - offset);
+
+                for (int channel = 0; channel < channelCount; channel++)
+                    channels[channel] = data + channel * numSamples + offset;
+
+                run(engine, channels, channelCount, offset, count, automation);
+                }
+            }
+        else {
+            auto* data = static_cast<double*>(audio.view.buf);
+            auto& scratch = *self->scratch;
+            float* channels[maxChannels];
+
+            for (int channel = 0; channel < channelCount; channel++)
+                channels[channel] = scratch.data() + (size_t) channel * scratchSize;
+
+            for (Py_ssize_t offset = 0; offset < numSamples; offset += scratchSize) {
+                const auto count = (int) std::min<Py_ssize_t>(scratchSize, numSamples - offset);
+
+                for (int channel = 0; channel < channelCount; channel++)
+                    for (int i = 0; i < count; i++)
+                        channels[channel][i] = (float) data[channel * numSamples + offset + i];
+
+                run(engine, channels, channelCount, offset, count, automation);
+
+                for (int channel = 0; channel < channelCount; channel++)
+                    for (int i = 0; i < count; i++)
+                        data[channel * numSamples + offset + i] = channels[channel][i];
+                }
+            }
+
+        Py_END_ALLOW_THREADS
+
+        self->busy = false;
+        Py_RETURN_NONE;
+    }
+
+    PyObject* Filter_reset(Filter* self, PyObject*)
+    {
+        if (! checkReady(self))
+            return nullptr;
+
+        self->engine->reset();
+        Py_RETURN_NONE;
+    }
+
+    PyObject* getParameter(Filter* self, void* closure)
+    {
+        if (! checkReady(self))
+            return nullptr;
+
+        return PyFloat_FromDouble(self->engine->getParameter((LadderEngine::Parameter) (intptr_t) closure));
+    }
+
+    int setParameter(Filter* self, PyObject* value, void* closure)
+    {
+        if (value == nullptr) {
+            PyErr_SetString(PyExc_AttributeError, "parameters can't be deleted");
+            return -1;
+            }
+
+        const auto number = PyFloat_AsDouble(value);
+
+        if (number == -1.0 && PyErr_Occurred())
+            return -1;
+
+        if (! checkReady(self))
+            return -1;
+
+        self->engine->setParameter((LadderEngine::Parameter) (intptr_t) closure, (float) number);
+        return 0;
+    }
+
+    PyObject* getSampleRate(Filter* self, void*) { return PyFloat_FromDouble(self->sampleRate); }
+    PyObject* getChannels(Filter* self, void*) { return PyLong_FromLong(self->numChannels); }
+
+    PyMethodDef filterMethods[] = {
+        { "process", (PyCFunction) (void(*)(void)) Filter_process, METH_VARARGS | METH_KEYWORDS,
+          "process(audio, drive=None, cutoff=None, resonance=None, trim=None)\n\n"
+          "Filters audio in place. audio is a writable, C-contiguous float32 or float64 array\n"
+          "of shape (channels, samples) or (samples,). Each automation argument is an array\n"
+          "with one value per sample and overrides that parameter while it lasts." },
+        { "reset", (PyCFunction) Filter_reset, METH_NOARGS, "Clears the filter state and jumps to the current parameters." },
+        { nullptr, nullptr, 0, nullptr }
+    };
+
+    PyGetSetDef filterProperties[] = {
+        { "drive", (getter) getParameter, (setter) setParameter, "0 to 10", (void*) (intptr_t) LadderEngine::Parameter::drive },
+        { "cutoff", (getter) getParameter, (setter) setParameter, "20 to 20000 Hz", (void*) (intptr_t) LadderEngine::Parameter::cutoff },
+        { "resonance", (getter) getParameter, (setter) setParameter, "0 to 1", (void*) (intptr_t) LadderEngine::Parameter::resonance },
+        { "trim", (getter) getParameter, (setter) setParameter, "-36 to 36 dB", (void*) (intptr_t) LadderEngine::Parameter::trim },
+        { "mode", (getter) getParameter, (setter) setParameter, "0 to 5: LP 12, HP 12, BP 12, LP 24, HP 24, BP 24", (void*) (intptr_t) LadderEngine::Parameter::mode },
+        { "sample_rate", (getter) getSampleRate, nullptr, "sample rate the filter was made for", nullptr },
+        { "channels", (getter) getChannels, nullptr, "most channels process() accepts", nullptr },
+        { nullptr, nullptr, nullptr, nullptr, nullptr }
+    };
+
+    PyTypeObject filterType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+
+    PyModuleDef moduleDefinition = {
+        PyModuleDef_HEAD_INIT, "ladder_core",
+        "The LadderFilter plugin's drive, ladder and trim chain, without the plugin.",
+        -1, nullptr
+    };
+}
+
+PyMODINIT_FUNC PyInit_ladder_core(void)
+{
+    filterType.tp_name = "ladder_core.Filter";
+    filterType.tp_doc = "Filter(sample_rate, channels=2)\n\nOne drive -> ladder -> trim chain. Parameters start at the plugin's defaults.";
+    filterType.tp_basicsize = sizeof (Filter);
+    filterType.tp_flags = Py_TPFLAGS_DEFAULT;
+    filterType.tp_new = PyType_GenericNew;
+    filterType.tp_init = (initproc) Filter_init;
+    filterType.tp_dealloc = (destructor) Filter_dealloc;
+    filterType.tp_methods = filterMethods;
+    filterType.tp_getset = filterProperties;
+
+    if (PyType_Ready(&filterType) < 0)
+        return nullptr;
+
+    auto* module = PyModule_Create(&moduleDefinition);
+
+    if (module == nullptr)
+        return nullptr;
+
+    Py_INCREF(&filterType);
+
+    if (PyModule_AddObject(module, "Filter", (PyObject*) &filterType) < 0) {
+        Py_DECREF(&filterType);
+        Py_DECREF(module);
+        return nullptr;
+        }
+
+    return module;
+}
@@ -0,0 +1,32 @@
+"""Builds the ladder_core Python module: python3 setup.py build_ext --inplace"""
+
+import os
+from setuptools import setup, Extension
+
+here = os.path.dirname(os.path.abspath(__file__))
+core = os.path.join(here, "..", "Source")
+
+setup(
+    name="ladder_core",
+    version="1.0",
+    description="The LadderFilter plugin's drive, ladder and trim chain, without the plugin",
+    ext_modules=[
+        Extension(
+            "ladder_core",
+            #the AVX2 and AVX-512 kernels need per-file flags, so this build uses the scalar
+            #and baseline ones; build with -DLADDER_BUILD_PYTHON=ON in CMake to get them all
+            sources=[
+                os.path.join(here, "LadderCoreModule.cpp"),
+                os.path.join(core, "CpuDispatch.cpp"),
+                os.path.join(core, "DspKernelsAvx2.cpp"),
+                os.path.join(core, "DspKernelsAvx512.cpp"),
+                os.path.join(core, "DspKernelsNeon.cpp"),
+                os.path.join(core, "DspKernelsScalar.cpp"),
+                os.path.join(core, "DspKernelsSse2.cpp"),
+                os.path.join(core, "LadderEngine.cpp"),
+                os.path.join(core, "SharedTables.cpp"),
+            ],
+            extra_compile_args=["-std=c++14", "-O2"],
+        )
+    ],
+)
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    CpuDispatch.cpp
+
+  ==============================================================================
+*/
+
+#include "CpuDispatch.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86)
+ #define LADDER_CPU_X86 1
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+  #include <immintrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+//defined by the DspKernels*.cpp files, nullptr where a set wasn't built
+extern const DspKernels* const dspKernelsScalar;
+extern const DspKernels* const dspKernelsSse2;
+extern const DspKernels* const dspKernelsAvx2;
+extern const DspKernels* const dspKernelsAvx512;
+extern const DspKernels* const dspKernelsNeon;
+
+namespace
+{
+    const DspKernels* getTable(InstructionSet instructionSet) noexcept
+    {
+        switch (instructionSet) {
+            case InstructionSet::scalar: return dspKernelsScalar;
+            case InstructionSet::sse2: return dspKernelsSse2;
+            case InstructionSet::avx2: return dspKernelsAvx2;
+            case InstructionSet::avx512: return dspKernelsAvx512;
+            case InstructionSet::neon: return dspKernelsNeon;
+            }
+
+        return nullptr;
+    }
+
+   #if LADDER_CPU_X86
+    struct Registers { unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0; };
+
+    Registers cpuid(unsigned int leaf) noexcept
+    {
+        Registers r;
+
+       #if defined (_MSC_VER)
+        int values[4];
+        __cpuid(values, 0);
+
+        if (leaf > (unsigned int) values[0])
+            return r;
+
+        __cpuidex(values, (int) leaf, 0);
+        r = { (unsigned int) values[0], (unsigned int) values[1], (unsigned int) values[2], (unsigned int) values[3] };
+       #else
+        if (leaf > __get_cpuid_max(0, nullptr))
+            return r;
+
+        __cpuid_count(leaf, 0, r.eax, r.ebx, r.ecx, r.edx);
+       #endif
+
+        return r;
+    }
+
+    //which register states the OS saves on a context switch
+    unsigned long long getEnabledStates() noexcept
+    {
+       #if defined (_MSC_VER)
+        return _xgetbv(0);
+       #else
+        unsigned int low, high;
+        __asm__ ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+        return ((unsigned long long) high << 32) | low;
+       #endif
+    }
+
+    bool hasBits(unsigned int value, unsigned int bits) noexcept { return (value & bits) == bits; }
+   #endif
+
+    bool cpuSupports(InstructionSet instructionSet) noexcept
+    {
+        if (instructionSet == InstructionSet::scalar)
+            return true;
+
+       #if LADDER_CPU_X86
+        const auto features = cpuid(1);
+
+        if (instructionSet == InstructionSet::sse2)
+            return hasBits(features.edx, 1u << 26);
+
+        //AVX, FMA and OSXSAVE, then YMM (and for AVX-512 opmask and ZMM) state enabled by the OS
+        if (instructionSet != InstructionSet::avx2 && instructionSet != InstructionSet::avx512)
+            return false;
+
+        if (! hasBits(features.ecx, (1u << 12) | (1u << 27) | (1u << 28)))
+            return false;
+
+        const auto states = getEnabledStates();
+        const auto extended = cpuid(7);
+
+        if ((states & 0x6) != 0x6 || ! hasBits(extended.ebx, 1u << 5))
+            return false;
+
+        if (instructionSet == InstructionSet::avx2)
+            return true;
+
+        //F, DQ, BW and VL, the x86-64-v4 set the AVX-512 file is built for
+        return (states & 0xe6) == 0xe6 && hasBits(extended.ebx, (1u << 16) | (1u << 17) | (1u << 30) | (1u << 31));
+       #else
+        //the NEON file is only built where NEON is part of the target
+        return instructionSet == InstructionSet::neon;
+       #endif
+    }
+
+    std::atomic<int> forced { -1 };
+
+    //the best set, or the one LADDER_FORCE_ISA names if it's available
+    InstructionSet getDefault() noexcept
+    {
+        static const auto choice = [] {
+            InstructionSet requested;
+            const auto* name = std::getenv("LADDER_FORCE_ISA");
+
+            if (name != nullptr && CpuDispatch::parse(name, requested) && CpuDispatch::isAvailable(requested))
+                return requested;
+
+            return CpuDispatch::getBest();
+        }();
+
+        return choice;
+    }
+}
+
+bool CpuDispatch::isAvailable(InstructionSet instructionSet) noexcept
+{
+    return getTable(instructionSet) != nullptr && cpuSupports(instructionSet);
+}
+
+InstructionSet CpuDispatch::getBest() noexcept
+{
+    for (auto instructionSet : { InstructionSet::avx512, InstructionSet::avx2, InstructionSet::sse2, InstructionSet::neon })
+        if (isAvailable(instructionSet))
+            return instructionSet;
+
+    return InstructionSet::scalar;
+}
+
+InstructionSet CpuDispatch::getActive() noexcept
+{
+    const auto forcedSet = forced.load(std::memory_order_acquire);
+    return forcedSet >= 0 ? (InstructionSet) forcedSet : getDefault();
+}
+
+const DspKernels* CpuDispatch::getKernels(InstructionSet instructionSet) noexcept
+{
+    return isAvailable(instructionSet) ? getTable(instructionSet) : nullptr;
+}
+
+const DspKernels& CpuDispatch::getKernels() noexcept
+{
+    return *getTable(getActive());
+}
+
+bool CpuDispatch::force(InstructionSet instructionSet) noexcept
+{
+    if (! isAvailable(instructionSet))
+        return false;
+
+    forced.store((int) instructionSet, std::memory_order_release);
+    return true;
+}
+
+void CpuDispatch::clearForced() noexcept
+{
+    forced.store(-1, std::memory_order_release);
+}
+
+const char* CpuDispatch::getName(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet) {
+        case InstructionSet::scalar: return "scalar";
+        case InstructionSet::sse2: return "sse2";
+        case InstructionSet::avx2: return "avx2";
+        case InstructionSet::avx512: return "avx512";
+        case InstructionSet::neon: return "neon";
+        }
+
+    return "unknown";
+}
+
+bool CpuDispatch::parse(const char* name, InstructionSet& result) noexcept
+{
+    for (auto instructionSet : allInstructionSets) {
+        if (std::strcmp(name, getName(instructionSet)) == 0) {
+            result = instructionSet;
+            return true;
+            }
+        }
+
+    return false;
+}
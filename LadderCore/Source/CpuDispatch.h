@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    CpuDispatch.h
+
+    The engine's hot loops (table saturation, the ladder, gain ramps) are
+    compiled once per instruction set, in DspKernelsScalar/Sse2/Avx2/
+    Avx512/Neon.cpp, and the best set this CPU supports is picked the first
+    time they're asked for. The choice can be forced for testing, with
+    CpuDispatch::force() or the LADDER_FORCE_ISA environment variable
+    (scalar, sse2, avx2, avx512 or neon).
+
+    A variant only exists if its file was built with the matching compiler
+    flags (the CMake build does this); otherwise it's left out and never
+    chosen. The scalar variant is always there and is the reference the
+    others are tested against.
+
+    DspKernels holds plain function pointers, so the table is fixed at
+    compile time and the variant files run no code until they are picked.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+enum class InstructionSet { scalar, sse2, avx2, avx512, neon };
+
+//==============================================================================
+/** Parameters the ladder loops read, copied from LadderKernel. */
+struct LadderLoopParameters
+{
+    const float* tanhValues;
+    float drive, drive2, gain, gain2;
+};
+
+//==============================================================================
+/** One instruction set's build of the hot loops. Every pointer is set. */
+struct DspKernels
+{
+    static constexpr int numModes = 6;
+
+    using LadderConstantLoop = void (*) (float* data, int numSamples, float* state, const LadderLoopParameters& parameters, float pole, float resonance);
+    using LadderVaryingLoop = void (*) (float* data, int numSamples, float* state, const LadderLoopParameters& parameters, const float* poles, const float* resonances);
+
+    InstructionSet instructionSet;
+
+    //data[i] = atan(inputGain * data[i]) * outputGain, atan from the SaturationTable values
+    void (*saturate) (float* data, int numSamples, const float* atanValues, float inputGain, float outputGain);
+    void (*saturateRamped) (float* data, int numSamples, const float* atanValues, const float* inputGains, const float* outputGains);
+
+    void (*applyGain) (float* data, int numSamples, float gain);
+    void (*applyGains) (float* data, int numSamples, const float* gains);
+
+    //one filter loop per LadderKernel::Mode, with a pole and resonance for the whole call or per sample
+    LadderConstantLoop ladderConstant[numModes];
+    LadderVaryingLoop ladderVarying[numModes];
+};
+
+//==============================================================================
+namespace CpuDispatch
+{
+    //the kernels in use: forced if a set was forced, otherwise the best available
+    const DspKernels& getKernels() noexcept;
+
+    //a specific set, or nullptr if it wasn't built or this CPU can't run it
+    const DspKernels* getKernels(InstructionSet instructionSet) noexcept;
+
+    bool isAvailable(InstructionSet instructionSet) noexcept;
+    InstructionSet getBest() noexcept;
+    InstructionSet getActive() noexcept;
+
+    //Affects kernels picked up afterwards, which engines do in prepare().
+    //Returns false and changes nothing if the set isn't available.
+    bool force(InstructionSet instructionSet) noexcept;
+    void clearForced() noexcept;
+
+    const char* getName(InstructionSet instructionSet) noexcept;
+    bool parse(const char* name, InstructionSet& result) noexcept;
+
+    constexpr InstructionSet allInstructionSets[] = { InstructionSet::scalar, InstructionSet::sse2, InstructionSet::avx2,
+                                                       InstructionSet::avx512, InstructionSet::neon };
+}
@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    DspKernelsAvx2.cpp
+
+    AVX2 and FMA (Haswell and later). Only built when this file is compiled
+    with -mavx2 -mfma or /arch:AVX2, which the CMake build does.
+
+  ==============================================================================
+*/
+
+#include "CpuDispatch.h"
+#include "LadderKernel.h"
+#include <immintrin.h>
+
+extern const DspKernels* const dspKernelsAvx2;
+
+#if defined (__AVX2__)
+
+namespace DspKernelsAvx2
+{
+    #include "DspKernelsBody.h"
+
+    constexpr auto table = makeTable(InstructionSet::avx2);
+}
+
+const DspKernels* const dspKernelsAvx2 = &DspKernelsAvx2::table;
+
+#else
+
+const DspKernels* const dspKernelsAvx2 = nullptr;
+
+#endif
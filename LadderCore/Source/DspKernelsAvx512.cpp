@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    DspKernelsAvx512.cpp
+
+    AVX-512 F, DQ, BW and VL (Skylake-SP and later). Only built when this file
+    is compiled with those flags or /arch:AVX512, which the CMake build does.
+
+  ==============================================================================
+*/
+
+#include "CpuDispatch.h"
+#include "LadderKernel.h"
+#include <immintrin.h>
+
+extern const DspKernels* const dspKernelsAvx512;
+
+#if defined (__AVX512F__) && defined (__AVX512DQ__) && defined (__AVX512BW__) && defined (__AVX512VL__)
+
+namespace DspKernelsAvx512
+{
+    #include "DspKernelsBody.h"
+
+    constexpr auto table = makeTable(InstructionSet::avx512);
+}
+
+const DspKernels* const dspKernelsAvx512 = &DspKernelsAvx512::table;
+
+#else
+
+const DspKernels* const dspKernelsAvx512 = nullptr;
+
+#endif
@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+    DspKernelsBody.h
+
+    The loops behind DspKernels. Not a normal header: each DspKernels*.cpp
+    includes it once, inside its own namespace, after including
+    CpuDispatch.h, LadderKernel.h and the intrinsics header for its set,
+    and gets a constexpr `table`.
+
+    Everything the loops call is defined here, with plain arithmetic or
+    intrinsics. An inline function from a shared header used here would be
+    compiled with this file's instruction set, and the linker could keep
+    that copy for every caller, so nothing outside is called, only
+    constants are read.
+
+    The compiler vectorises the gain loops by itself. The saturation reads
+    the table at a different place for every sample, which it won't turn
+    into gathers, so AVX2 and AVX-512 have them written out.
+
+  ==============================================================================
+*/
+
+//same arithmetic as SaturationTable::lookup()
+inline float lookup(const float* values, float position) noexcept
+{
+    const auto index = (int) position;
+    const auto fraction = position - (float) index;
+    return values[index] + fraction * (values[index + 1] - values[index]);
+}
+
+constexpr auto atanTableSize = (float) SaturationTable::size;
+constexpr auto halfPi = 1.57079632679489661923f;
+
+//SaturationTable::atan() without branches around the lookup, the same steps as the vector
+//versions below. Above 1 the table is read at size / |x|, which is then the smaller of the
+//two positions. 1/inf reads atan(0) and gives pi/2 as before; NaN is kept inside the table.
+inline float tableAtan(const float* values, float x) noexcept
+{
+    //0 + x turns -0 into +0, or size / magnitude would be -inf
+    const auto magnitude = x < 0.0f ? -x : 0.0f + x;
+    const auto direct = magnitude * atanTableSize;
+    const auto reciprocal = atanTableSize / magnitude;
+    auto position = direct < reciprocal ? direct : reciprocal;
+    position = position < atanTableSize ? position : atanTableSize;
+
+    const auto value = lookup(values, position);
+    const auto result = magnitude > 1.0f ? halfPi - value : value;
+    return x < 0.0f ? -result : result;
+}
+
+#if defined (__AVX2__)
+inline __m256 tableAtan(const float* values, __m256 x) noexcept
+{
+    const auto signBit = _mm256_set1_ps(-0.0f);
+    const auto size = _mm256_set1_ps(atanTableSize);
+
+    //min_ps(a, b) is a < b ? a : b, as in the scalar version, NaN included
+    const auto magnitude = _mm256_andnot_ps(signBit, x);
+    auto position = _mm256_min_ps(_mm256_mul_ps(magnitude, size), _mm256_div_ps(size, magnitude));
+    position = _mm256_min_ps(position, size);
+
+    const auto index = _mm256_cvttps_epi32(position);
+    const auto fraction = _mm256_sub_ps(position, _mm256_cvtepi32_ps(index));
+    const auto low = _mm256_i32gather_ps(values, index, 4);
+    const auto high = _mm256_i32gather_ps(values + 1, index, 4);
+    const auto value = _mm256_add_ps(low, _mm256_mul_ps(fraction, _mm256_sub_ps(high, low)));
+
+    const auto inverted = _mm256_cmp_ps(magnitude, _mm256_set1_ps(1.0f), _CMP_GT_OQ);
+    const auto result = _mm256_blendv_ps(value, _mm256_sub_ps(_mm256_set1_ps(halfPi), value), inverted);
+    return _mm256_or_ps(result, _mm256_and_ps(signBit, x));
+}
+#endif
+
+#if defined (__AVX512F__)
+inline __m512 tableAtan(const float* values, __m512 x) noexcept
+{
+    const auto size = _mm512_set1_ps(atanTableSize);
+
+    const auto magnitude = _mm512_abs_ps(x);
+    auto position = _mm512_min_ps(_mm512_mul_ps(magnitude, size), _mm512_div_ps(size, magnitude));
+    position = _mm512_min_ps(position, size);
+
+    const auto index = _mm512_cvttps_epi32(position);
+    const auto fraction = _mm512_sub_ps(position, _mm512_cvtepi32_ps(index));
+    const auto low = _mm512_i32gather_ps(index, values, 4);
+    const auto high = _mm512_i32gather_ps(index, values + 1, 4);
+    const auto value = _mm512_add_ps(low, _mm512_mul_ps(fraction, _mm512_sub_ps(high, low)));
+
+    const auto inverted = _mm512_cmp_ps_mask(magnitude, _mm512_set1_ps(1.0f), _CMP_GT_OQ);
+    const auto result = _mm512_mask_sub_ps(value, inverted, _mm512_set1_ps(halfPi), value);
+    const auto sign = _mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32((int) 0x80000000u));
+    return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(result), sign));
+}
+#endif
+
+inline float tableTanh(const float* values, float x) noexcept
+{
+    const auto magnitude = x < 0.0f ? -x : x;
+    auto result = 1.0f;
+
+    if (magnitude < SaturationTable::tanhRange)
+        result = lookup(values, magnitude * (SaturationTable::size / SaturationTable::tanhRange));
+
+    return x < 0.0f ? -result : result;
+}
+
+//the widest vectors first, then whatever is left one sample at a time
+void saturate(float* data, int numSamples, const float* atanValues, float inputGain, float outputGain)
+{
+    int i = 0;
+
+   #if defined (__AVX512F__)
+    for (; i + 16 <= numSamples; i += 16) {
+        const auto x = _mm512_mul_ps(_mm512_loadu_ps(data + i), _mm512_set1_ps(inputGain));
+        _mm512_storeu_ps(data + i, _mm512_mul_ps(tableAtan(atanValues, x), _mm512_set1_ps(outputGain)));
+        }
+   #endif
+
+   #if defined (__AVX2__)
+    for (; i + 8 <= numSamples; i += 8) {
+        const auto x = _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_set1_ps(inputGain));
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(tableAtan(atanValues, x), _mm256_set1_ps(outputGain)));
+        }
+   #endif
+
+    for (; i < numSamples; i++)
+        data[i] = tableAtan(atanValues, inputGain * data[i]) * outputGain;
+}
+
+void saturateRamped(float* data, int numSamples, const float* atanValues, const float* inputGains, const float* outputGains)
+{
+    int i = 0;
+
+   #if defined (__AVX512F__)
+    for (; i + 16 <= numSamples; i += 16) {
+        const auto x = _mm512_mul_ps(_mm512_loadu_ps(data + i), _mm512_loadu_ps(inputGains + i));
+        _mm512_storeu_ps(data + i, _mm512_mul_ps(tableAtan(atanValues, x), _mm512_loadu_ps(outputGains + i)));
+        }
+   #endif
+
+   #if defined (__AVX2__)
+    for (; i + 8 <= numSamples; i += 8) {
+        const auto x = _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(inputGains + i));
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(tableAtan(atanValues, x), _mm256_loadu_ps(outputGains + i)));
+        }
+   #endif
+
+    for (; i < numSamples; i++)
+        data[i] = tableAtan(atanValues, inputGains[i] * data[i]) * outputGains[i];
+}
+
+void applyGain(float* data, int numSamples, float gain)
+{
+    for (int i = 0; i < numSamples; i++)
+        data[i] *= gain;
+}
+
+void applyGains(float* data, int numSamples, const float* gains)
+{
+    for (int i = 0; i < numSamples; i++)
+        data[i] *= gains[i];
+}
+
+//coefficient sources for the ladder loop, one value for the call or one per sample
+struct Constant
+{
+    float pole, resonance;
+    float getPole(int) const noexcept { return pole; }
+    float getResonance(int) const noexcept { return resonance; }
+};
+
+struct Varying
+{
+    const float* poles;
+    const float* resonances;
+    float getPole(int i) const noexcept { return poles[i]; }
+    float getResonance(int i) const noexcept { return resonances[i]; }
+};
+
+//juce::dsp::LadderFilter's processSample with the mode's tap mix folded in at compile time.
+//The state is copied into locals so it can stay in registers.
+template <LadderKernel::Mode mode, typename Coefficients>
+void runLadder(float* data, int numSamples, float* state, const LadderLoopParameters& p, Coefficients coefficients)
+{
+    constexpr auto tapMix = LadderKernel::getTapMix(mode);
+    float s0 = state[0], s1 = state[1], s2 = state[2], s3 = state[3], s4 = state[4];
+
+    for (int i = 0; i < numSamples; i++) {
+        const auto a1 = coefficients.getPole(i);
+        const auto resonance = coefficients.getResonance(i);
+        const auto g = 1.0f - a1;
+        const auto b0 = g * 0.76923076923f;
+        const auto b1 = g * 0.23076923076f;
+
+        const auto dx = p.gain * tableTanh(p.tanhValues, p.drive * data[i]);
+        const auto a = dx + resonance * -4.0f * (p.gain2 * tableTanh(p.tanhValues, p.drive2 * s4) - dx * tapMix.compensation);
+
+        const auto b = b1 * s0 + a1 * s1 + b0 * a;
+        const auto c = b1 * s1 + a1 * s2 + b0 * b;
+        const auto d = b1 * s2 + a1 * s3 + b0 * c;
+        const auto e = b1 * s3 + a1 * s4 + b0 * d;
+
+        s0 = a; s1 = b; s2 = c; s3 = d; s4 = e;
+
+        float output = 0.0f;
+
+        if (tapMix.taps[0] != 0.0f) output += a * tapMix.taps[0];
+        if (tapMix.taps[1] != 0.0f) output += b * tapMix.taps[1];
+        if (tapMix.taps[2] != 0.0f) output += c * tapMix.taps[2];
+        if (tapMix.taps[3] != 0.0f) output += d * tapMix.taps[3];
+        if (tapMix.taps[4] != 0.0f) output += e * tapMix.taps[4];
+
+        data[i] = output;
+        }
+
+    state[0] = s0; state[1] = s1; state[2] = s2; state[3] = s3; state[4] = s4;
+}
+
+template <LadderKernel::Mode mode>
+void ladderConstant(float* data, int numSamples, float* state, const LadderLoopParameters& parameters, float pole, float resonance)
+{
+    runLadder<mode>(data, numSamples, state, parameters, Constant { pole, resonance });
+}
+
+template <LadderKernel::Mode mode>
+void ladderVarying(float* data, int numSamples, float* state, const LadderLoopParameters& parameters, const float* poles, const float* resonances)
+{
+    runLadder<mode>(data, numSamples, state, parameters, Varying { poles, resonances });
+}
+
+//in LadderKernel::Mode order
+constexpr DspKernels makeTable(InstructionSet instructionSet) noexcept
+{
+    using Mode = LadderKernel::Mode;
+
+    return { instructionSet, saturate, saturateRamped, applyGain, applyGains,
+             { ladderConstant<Mode::LPF12>, ladderConstant<Mode::HPF12>, ladderConstant<Mode::BPF12>,
+               ladderConstant<Mode::LPF24>, ladderConstant<Mode::HPF24>, ladderConstant<Mode::BPF24> },
+             { ladderVarying<Mode::LPF12>, ladderVarying<Mode::HPF12>, ladderVarying<Mode::BPF12>,
+               ladderVarying<Mode::LPF24>, ladderVarying<Mode::HPF24>, ladderVarying<Mode::BPF24> } };
+}
@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    DspKernelsNeon.cpp
+
+    NEON, always present on 64-bit ARM.
+
+  ==============================================================================
+*/
+
+#include "CpuDispatch.h"
+#include "LadderKernel.h"
+
+extern const DspKernels* const dspKernelsNeon;
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+
+namespace DspKernelsNeon
+{
+    #include "DspKernelsBody.h"
+
+    constexpr auto table = makeTable(InstructionSet::neon);
+}
+
+const DspKernels* const dspKernelsNeon = &DspKernelsNeon::table;
+
+#else
+
+const DspKernels* const dspKernelsNeon = nullptr;
+
+#endif
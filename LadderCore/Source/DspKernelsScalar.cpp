@@ -0,0 +1,23 @@
+/*
+  ==============================================================================
+
+    DspKernelsScalar.cpp
+
+    The reference the other sets are tested against. The CMake build turns
+    auto-vectorisation off for this file, so the loops run one sample at a time.
+
+  ==============================================================================
+*/
+
+#include "CpuDispatch.h"
+#include "LadderKernel.h"
+
+namespace DspKernelsScalar
+{
+    #include "DspKernelsBody.h"
+
+    constexpr auto table = makeTable(InstructionSet::scalar);
+}
+
+extern const DspKernels* const dspKernelsScalar;
+const DspKernels* const dspKernelsScalar = &DspKernelsScalar::table;
@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    DspKernelsSse2.cpp
+
+    SSE2, the x86-64 baseline that every 64-bit x86 CPU has.
+
+  ==============================================================================
+*/
+
+#include "CpuDispatch.h"
+#include "LadderKernel.h"
+
+extern const DspKernels* const dspKernelsSse2;
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+
+namespace DspKernelsSse2
+{
+    #include "DspKernelsBody.h"
+
+    constexpr auto table = makeTable(InstructionSet::sse2);
+}
+
+const DspKernels* const dspKernelsSse2 = &DspKernelsSse2::table;
+
+#else
+
+const DspKernels* const dspKernelsSse2 = nullptr;
+
+#endif
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    LadderCore.cpp
+
+  ==============================================================================
+*/
+
+#define LADDER_CORE_BUILDING 1
+#include "LadderCore.h"
+#include "LadderEngine.h"
+#include <new>
+
+struct ladder_engine
+{
+    LadderEngine engine;
+};
+
+namespace
+{
+    bool isValid(ladder_param param) noexcept
+    {
+        return param >= LADDER_PARAM_DRIVE && param <= LADDER_PARAM_MODE;
+    }
+}
+
+int ladder_core_api_version(void)
+{
+    return LADDER_CORE_API_VERSION;
+}
+
+ladder_engine* ladder_create(void)
+{
+    //the constructor takes the shared tables, which can throw as well as the allocation
+    try {
+        return new ladder_engine;
+        }
+    catch (...) {
+        return nullptr;
+        }
+}
+
+void ladder_destroy(ladder_engine* engine)
+{
+    delete engine;
+}
+
+ladder_status ladder_prepare(ladder_engine* engine, double sample_rate, int num_channels)
+{
+    //an infinite rate passes > 0 but makes no sense of the ramp lengths
+    if (engine == nullptr || ! (sample_rate > 0.0) || std::isinf(sample_rate) || num_channels <= 0)
+        return LADDER_ERROR_INVALID_ARGUMENT;
+
+    //nothing may throw across the C boundary
+    try {
+        engine->engine.prepare(sample_rate, num_channels);
+        }
+    catch (...) {
+        //bad_alloc, or system_error from the table registry's lock; either way out of resources
+        return LADDER_ERROR_OUT_OF_MEMORY;
+        }
+
+    return LADDER_OK;
+}
+
+ladder_status ladder_reset(ladder_engine* engine)
+{
+    if (engine == nullptr)
+        return LADDER_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.reset();
+    return LADDER_OK;
+}
+
+ladder_status ladder_set_param(ladder_engine* engine, ladder_param param, float value)
+{
+    if (engine == nullptr || ! isValid(param))
+        return LADDER_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.setParameter((LadderEngine::Parameter) param, value);
+    return LADDER_OK;
+}
+
+ladder_status ladder_get_param(const ladder_engine* engine, ladder_param param, float* value)
+{
+    if (engine == nullptr || value == nullptr || ! isValid(param))
+        return LADDER_ERROR_INVALID_ARGUMENT;
+
+    *value = engine->engine.getParameter((LadderEngine::Parameter) param);
+    return LADDER_OK;
+}
+
+ladder_status ladder_process(ladder_engine* engine, float* const* channels, int num_channels, int num_samples)
+{
+    if (engine == nullptr || num_channels < 0 || num_samples < 0 || (channels == nullptr && num_channels > 0))
+        return LADDER_ERROR_INVALID_ARGUMENT;
+
+    if (! engine->engine.isPrepared())
+        return LADDER_ERROR_NOT_PREPARED;
+
+    if (num_channels > engine->engine.getNumChannels())
+        return LADDER_ERROR_INVALID_ARGUMENT;
+
+    for (int channel = 0; channel < num_channels; channel++)
+        if (channels[channel] == nullptr && num_samples > 0)
+            return LADDER_ERROR_INVALID_ARGUMENT;
+
+    engine->engine.process(channels, num_channels, num_samples);
+    return LADDER_OK;
+}
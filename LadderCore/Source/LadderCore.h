@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    LadderCore.h
+
+    C API for the ladder engine (LadderEngine.h), for hosts that aren't
+    JUCE plugins: batch renderers, game audio runtimes, other languages.
+    The interface is append only. New functions and parameters can be
+    added, but existing names, values and signatures stay as they are.
+
+    An engine is not thread-safe. Each one belongs to one thread at a time,
+    and separate engines can run on separate threads.
+
+  ==============================================================================
+*/
+
+#ifndef LADDER_CORE_H
+#define LADDER_CORE_H
+
+#if defined (_WIN32) && defined (LADDER_CORE_SHARED)
+ #if defined (LADDER_CORE_BUILDING)
+  #define LADDER_CORE_API __declspec(dllexport)
+ #else
+  #define LADDER_CORE_API __declspec(dllimport)
+ #endif
+#elif defined (__GNUC__) && defined (LADDER_CORE_SHARED)
+ #define LADDER_CORE_API __attribute__((visibility ("default")))
+#else
+ #define LADDER_CORE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bumped when something is added, compare against ladder_core_api_version() */
+#define LADDER_CORE_API_VERSION 1
+
+typedef struct ladder_engine ladder_engine;
+
+/* the plugin's parameters, in its units: drive 0-10, cutoff 20-20000 Hz,
+   resonance 0-1, trim -36 to 36 dB, mode 0-5 (LP 12, HP 12, BP 12, LP 24, HP 24, BP 24) */
+typedef enum ladder_param
+{
+    LADDER_PARAM_DRIVE = 0,
+    LADDER_PARAM_CUTOFF = 1,
+    LADDER_PARAM_RESONANCE = 2,
+    LADDER_PARAM_TRIM = 3,
+    LADDER_PARAM_MODE = 4
+} ladder_param;
+
+typedef enum ladder_status
+{
+    LADDER_OK = 0,
+    LADDER_ERROR_INVALID_ARGUMENT = -1,
+    LADDER_ERROR_NOT_PREPARED = -2,
+    LADDER_ERROR_OUT_OF_MEMORY = -3
+} ladder_status;
+
+LADDER_CORE_API int ladder_core_api_version(void);
+
+/* returns NULL if the engine or its shared tables can't be created, parameters start at the plugin's defaults */
+LADDER_CORE_API ladder_engine* ladder_create(void);
+LADDER_CORE_API void ladder_destroy(ladder_engine* engine);
+
+/* allocates, call before processing and whenever the rate or channel count changes;
+   the rate has to be positive and finite */
+LADDER_CORE_API ladder_status ladder_prepare(ladder_engine* engine, double sample_rate, int num_channels);
+LADDER_CORE_API ladder_status ladder_reset(ladder_engine* engine);
+
+/* values are clamped to the parameter's range, changes ramp over 50 ms once prepared */
+LADDER_CORE_API ladder_status ladder_set_param(ladder_engine* engine, ladder_param param, float value);
+LADDER_CORE_API ladder_status ladder_get_param(const ladder_engine* engine, ladder_param param, float* value);
+
+/* processes num_channels non-interleaved buffers of num_samples in place,
+   no more channels than were prepared */
+LADDER_CORE_API ladder_status ladder_process(ladder_engine* engine, float* const* channels, int num_channels, int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
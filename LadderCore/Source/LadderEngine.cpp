@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    LadderEngine.cpp
+
+  ==============================================================================
+*/
+
+#include "LadderEngine.h"
+#include "NoDenormals.h"
+
+namespace
+{
+    struct Range { float minimum, maximum, defaultValue; };
+
+    //the plugin's parameter layout
+    constexpr Range ranges[LadderEngine::numParameters] = {
+        { 0.0f, 10.0f, 0.0f },
+        { 20.0f, 20000.0f, 750.0f },
+        { 0.0f, 1.0f, 0.5f },
+        { -36.0f, 36.0f, 0.0f },
+        { 0.0f, 5.0f, 0.0f }
+    };
+
+    float decibelsToGain(float decibels) noexcept { return std::pow(10.0f, decibels * 0.05f); }
+}
+
+LadderEngine::LadderEngine() : kernels(&CpuDispatch::getKernels())
+{
+    for (size_t i = 0; i < values.size(); i++)
+        values[i] = ranges[i].defaultValue;
+
+    ladder.setDrive(1.0f);
+    ladder.setCutoffFrequencyHz(values[(size_t) Parameter::cutoff]);
+    ladder.setResonance(values[(size_t) Parameter::resonance]);
+    updateDrive();
+}
+
+float LadderEngine::getMinimum(Parameter parameter) noexcept { return ranges[(size_t) parameter].minimum; }
+float LadderEngine::getMaximum(Parameter parameter) noexcept { return ranges[(size_t) parameter].maximum; }
+float LadderEngine::getDefault(Parameter parameter) noexcept { return ranges[(size_t) parameter].defaultValue; }
+
+void LadderEngine::prepare(double sampleRate, int newNumChannels)
+{
+    saturation = SharedTables::getSaturation();
+    kernels = &CpuDispatch::getKernels();
+    numChannels = std::max(1, newNumChannels);
+
+    ladder.prepare(sampleRate, numChannels);
+    ladder.setDrive(1.0f);
+
+    const auto steps = (int) std::floor(rampSeconds * sampleRate);
+    inputGain.steps = outputGain.steps = trimGain.steps = steps;
+
+    reset();
+}
+
+void LadderEngine::reset() noexcept
+{
+    ladder.reset();
+    inputGain.snap();
+    outputGain.snap();
+    trimGain.snap();
+}
+
+void LadderEngine::setParameter(Parameter parameter, float value) noexcept
+{
+    const auto& range = ranges[(size_t) parameter];
+
+    //NaN keeps the old value
+    if (! (value == value))
+        return;
+
+    value = std::min(range.maximum, std::max(range.minimum, value));
+
+    //cheap to call every block with the same value
+    if (value == values[(size_t) parameter])
+        return;
+
+    values[(size_t) parameter] = value;
+
+    switch (parameter) {
+        case Parameter::drive: updateDrive(); break;
+        case Parameter::cutoff: ladder.setCutoffFrequencyHz(value); break;
+        case Parameter::resonance: ladder.setResonance(value); break;
+        case Parameter::trim: trimGain.setTarget(decibelsToGain(value)); break;
+        case Parameter::mode: ladder.setMode((LadderKernel::Mode) (int) value); break;
+        }
+}
+
+void LadderEngine::updateDrive() noexcept
+{
+    //the plugin's softClip gains
+    const auto drive = values[(size_t) Parameter::drive] * 5.0f;
+    inputGain.setTarget(std::pow(10.0f, drive * 0.05f));
+    outputGain.setTarget(0.63661977236f * 1.5f * std::pow(10.0f, -drive * 0.04f));
+}
+
+void LadderEngine::process(float* const* channels, int numChannelsToProcess, int numSamples) noexcept
+{
+    if (! isPrepared() || numSamples <= 0)
+        return;
+
+    NoDenormals noDenormals;
+    numChannelsToProcess = std::min(numChannelsToProcess, numChannels);
+    const auto* atanValues = saturation->getAtanValues();
+
+    if (inputGain.isRamping() || outputGain.isRamping()) {
+        for (int start = 0; start < numSamples; start += rampChunkSize) {
+            const auto count = std::min((int) rampChunkSize, numSamples - start);
+
+            for (int i = 0; i < count; i++) {
+                inputGains[(size_t) i] = inputGain.next();
+                outputGains[(size_t) i] = outputGain.next();
+                }
+
+            for (int channel = 0; channel < numChannelsToProcess; channel++)
+                kernels->saturateRamped(channels[channel] + start, count, atanValues, inputGains.data(), outputGains.data());
+            }
+        }
+    else {
+        for (int channel = 0; channel < numChannelsToProcess; channel++)
+            kernels->saturate(channels[channel], numSamples, atanValues, inputGain.target, outputGain.target);
+        }
+
+    ladder.process(channels, numChannelsToProcess, numSamples);
+
+    if (trimGain.isRamping()) {
+        for (int start = 0; start < numSamples; start += rampChunkSize) {
+            const auto count = std::min((int) rampChunkSize, numSamples - start);
+
+            for (int i = 0; i < count; i++)
+                trimGains[(size_t) i] = trimGain.next();
+
+            for (int channel = 0; channel < numChannelsToProcess; channel++)
+                kernels->applyGains(channels[channel] + start, count, trimGains.data());
+            }
+        }
+    else if (trimGain.target != 1.0f) {
+        for (int channel = 0; channel < numChannelsToProcess; channel++)
+            kernels->applyGain(channels[channel], numSamples, trimGain.target);
+        }
+}
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    LadderEngine.h
+
+    The plugin's drive -> ladder -> trim chain on its own, with no JUCE or
+    plugin wrapper: atan saturation from the shared table, the LadderKernel
+    and an output gain. Parameters take the plugin's ranges and units and
+    are ramped over 50 ms like the plugin's. Not thread-safe; set parameters
+    from the thread that calls process(), or between calls.
+
+    The per-sample loops run through CpuDispatch's kernels, picked again
+    in prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "LadderKernel.h"
+#include "SharedTables.h"
+
+class LadderEngine
+{
+public:
+    //same order and units as the plugin's parameters, and the C API's ladder_param
+    enum class Parameter { drive, cutoff, resonance, trim, mode };
+    static constexpr int numParameters = 5;
+
+    LadderEngine();
+
+    //Allocates, call before process() and again when the rate or channel count changes
+    void prepare(double sampleRate, int numChannels);
+    void reset() noexcept;
+
+    bool isPrepared() const noexcept { return numChannels > 0; }
+    int getNumChannels() const noexcept { return numChannels; }
+
+    //Clamped to the plugin's range, mode is a LadderKernel::Mode index. Unchanged values cost nothing.
+    void setParameter(Parameter parameter, float value) noexcept;
+    float getParameter(Parameter parameter) const noexcept { return values[(size_t) parameter]; }
+
+    static float getMinimum(Parameter parameter) noexcept;
+    static float getMaximum(Parameter parameter) noexcept;
+    static float getDefault(Parameter parameter) noexcept;
+
+    //In place, with denormals flushed to zero. Channels beyond the prepared count are left untouched.
+    void process(float* const* channels, int numChannels, int numSamples) noexcept;
+
+private:
+
+    //juce::SmoothedValue's two ramps, multiplicative for the drive gains, linear for the trim
+    template <bool multiplicative>
+    struct Ramp
+    {
+        float current = 1.0f, target = 1.0f, step = 0.0f;
+        int countdown = 0, steps = 0;
+
+        bool isRamping() const noexcept { return countdown > 0; }
+        void snap() noexcept { current = target; countdown = 0; }
+
+        void setTarget(float newTarget) noexcept
+        {
+            if (newTarget == target)
+                return;
+
+            target = newTarget;
+            countdown = steps;
+
+            if (countdown <= 0)
+                snap();
+            else
+                step = multiplicative ? std::exp((std::log(target) - std::log(current)) / (float) countdown)
+                                      : (target - current) / (float) countdown;
+        }
+
+        float next() noexcept
+        {
+            if (countdown <= 0)
+                return target;
+
+            --countdown;
+            current = countdown > 0 ? (multiplicative ? current * step : current + step) : target;
+            return current;
+        }
+    };
+
+    void updateDrive() noexcept;
+
+    static constexpr double rampSeconds = 0.05;
+
+    //ramped gains are worked out this many at a time, then applied to every channel
+    static constexpr int rampChunkSize = 256;
+
+    std::array<float, numParameters> values {};
+    int numChannels = 0;
+
+    std::shared_ptr<const SaturationTable> saturation;
+    const DspKernels* kernels;
+    LadderKernel ladder;
+    Ramp<true> inputGain, outputGain;
+    Ramp<false> trimGain;
+    std::array<float, rampChunkSize> inputGains {}, outputGains {}, trimGains {};
+};
@@ -0,0 +1,387 @@
+/*
+  ==============================================================================
+
+    LadderKernel.h
+
+    The four-pole ladder from juce::dsp::LadderFilter (same stages, feedback,
+    tap mixes and 50 ms smoothing of the pole coefficient and resonance),
+    rewritten so the pole coefficient can change every sample. process()
+    behaves like LadderFilter; processModulated() takes a per-sample cutoff
+    offset in octaves and looks the coefficients up in the shared
+    CutoffTable, a chunk at a time ahead of the filter loop.
+
+    Each mode has its own instantiation of the filter loop with its tap mix
+    folded in at compile time. The loops live in DspKernelsBody.h, built
+    once per instruction set, and the set is picked in the constructor and
+    prepare() (CpuDispatch.h). A mode change crossfades from the old loop
+    to the new one.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "CpuDispatch.h"
+#include "SharedTables.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class LadderKernel
+{
+public:
+    //same order as juce::dsp::LadderFilterMode
+    enum class Mode { LPF12, HPF12, BPF12, LPF24, HPF24, BPF24 };
+
+    struct TapMix
+    {
+        std::array<float, 5> taps;
+        float compensation;
+    };
+
+    //output weights of the five ladder taps and the passband compensation for a mode
+    static constexpr TapMix getTapMix(Mode mode) noexcept
+    {
+        //LadderFilter scales every tap by 1.2
+        switch (mode) {
+            case Mode::HPF12: return { {{ 1.2f, -2.4f,  1.2f,  0.0f, 0.0f }}, 0.0f };
+            case Mode::BPF12: return { {{ 0.0f,  0.0f, -1.2f,  1.2f, 0.0f }}, 0.5f };
+            case Mode::LPF24: return { {{ 0.0f,  0.0f,  0.0f,  0.0f, 1.2f }}, 0.5f };
+            case Mode::HPF24: return { {{ 1.2f, -4.8f,  7.2f, -4.8f, 1.2f }}, 0.0f };
+            case Mode::BPF24: return { {{ 0.0f,  0.0f,  1.2f, -2.4f, 1.2f }}, 0.5f };
+            case Mode::LPF12: break;
+            }
+
+        return { {{ 0.0f, 0.0f, 1.2f, 0.0f, 0.0f }}, 0.5f };
+    }
+
+    //same starting point as LadderFilter's constructor
+    LadderKernel() : saturation(SharedTables::getSaturation()), kernels(&CpuDispatch::getKernels())
+    {
+        setCutoffFrequencyHz(200.0f);
+        setResonance(0.0f);
+        setDrive(1.2f);
+    }
+
+    //Allocates the channel state, not real-time safe
+    void prepare(double newSampleRate, int numChannels)
+    {
+        sampleRate = newSampleRate;
+        cutoffTable = SharedTables::getCutoff(sampleRate);
+        kernels = &CpuDispatch::getKernels();
+
+        const auto rampSteps = (int) std::floor(0.05 * sampleRate);
+        poleRamp.reset(rampSteps);
+        resonanceRamp.reset(rampSteps);
+        octaveRamp.reset(rampSteps);
+        baseResonanceRamp.reset(rampSteps);
+
+        state.assign((size_t) numChannels, {});
+        fadeState.assign((size_t) numChannels, {});
+        fadeScratch.resize((size_t) numChannels);
+        fadeLength = std::max(1, (int) (0.01 * sampleRate));
+        fadeRemaining = 0;
+
+        setCutoffFrequencyHz(cutoffHz);
+        reset();
+    }
+
+    //Frees the channel state and lets go of the cutoff table. Until the next prepare()
+    //the process calls leave the audio untouched.
+    void release() noexcept
+    {
+        std::vector<State>().swap(state);
+        std::vector<State>().swap(fadeState);
+        std::vector<std::array<float, chunkSize>>().swap(fadeScratch);
+        cutoffTable.reset();
+        fadeRemaining = 0;
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channelState : state)
+            channelState.fill(0.0f);
+
+        fadeRemaining = 0;
+
+        poleRamp.snap();
+        resonanceRamp.snap();
+        octaveRamp.snap();
+        baseResonanceRamp.snap();
+    }
+
+    //Once prepared, the old mode keeps running on a copy of the state and fades out over 10 ms
+    void setMode(Mode newMode) noexcept
+    {
+        if (newMode == mode)
+            return;
+
+        if (! state.empty()) {
+            std::copy(state.begin(), state.end(), fadeState.begin());
+            fadeMode = mode;
+            fadeRemaining = fadeLength;
+            }
+
+        mode = newMode;
+    }
+
+    Mode getMode() const noexcept { return mode; }
+
+    void setCutoffFrequencyHz(float newCutoff) noexcept
+    {
+        cutoffHz = newCutoff;
+        poleRamp.setTarget(std::exp(cutoffHz * float (-2.0 * 3.14159265358979323846 / sampleRate)));
+        octaveRamp.setTarget(std::log2(std::max(cutoffHz, CutoffTable::minCutoff) / CutoffTable::minCutoff));
+    }
+
+    void setResonance(float newResonance) noexcept
+    {
+        resonanceRamp.setTarget(scaleResonance(newResonance));
+        baseResonanceRamp.setTarget(newResonance);
+    }
+
+    void setDrive(float newDrive) noexcept
+    {
+        drive = newDrive;
+        gain = std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+        drive2 = drive * 0.04f + 0.96f;
+        gain2 = std::pow(drive2, -2.642f) * 0.6103f + 0.3903f;
+    }
+
+    //Static cutoff, smoothed exactly like LadderFilter
+    void process(float* const* channels, int numChannels, int numSamples) noexcept
+    {
+        numChannels = std::min(numChannels, (int) state.size());
+        const auto parameters = getLoopParameters();
+
+        for (int start = 0; start < numSamples; start += chunkSize) {
+            const auto count = std::min((int) chunkSize, numSamples - start);
+
+            if (! poleRamp.isRamping() && ! resonanceRamp.isRamping()) {
+                const auto pole = poleRamp.current, resonance = resonanceRamp.current;
+
+                filterChunk(channels, numChannels, start, count, [&] (Mode loopMode, float* data, float* channelState) {
+                    kernels->ladderConstant[(size_t) loopMode](data, count, channelState, parameters, pole, resonance);
+                });
+
+                continue;
+                }
+
+            for (int i = 0; i < count; i++) {
+                poles[(size_t) i] = poleRamp.next();
+                resonances[(size_t) i] = resonanceRamp.next();
+                }
+
+            filterVaryingChunk(channels, numChannels, start, count, parameters);
+            }
+
+        //the modulated paths start from wherever these have got to
+        octaveRamp.skip(numSamples);
+        baseResonanceRamp.skip(numSamples);
+    }
+
+    //Cutoff moved every sample by offsetOctaves[i], on top of the smoothed cutoff.
+    //The resonance moves linearly to its smoothed value plus resonanceOffset by the end.
+    void processModulated(float* const* channels, int numChannels, int numSamples, const float* offsetOctaves, float resonanceOffset = 0.0f) noexcept
+    {
+        if (numSamples <= 0 || cutoffTable == nullptr)
+            return;
+
+        numChannels = std::min(numChannels, (int) state.size());
+        const auto parameters = getLoopParameters();
+        auto resonance = resonanceRamp.current;
+        const auto resonanceStep = (getModulatedResonance(numSamples, resonanceOffset) - resonance) / (float) numSamples;
+
+        for (int start = 0; start < numSamples; start += chunkSize) {
+            const auto count = std::min((int) chunkSize, numSamples - start);
+
+            //all the coefficient work happens here, ahead of the filter loop
+            for (int i = 0; i < count; i++)
+                poles[(size_t) i] = cutoffTable->getCoefficientForOctave(octaveRamp.next() + offsetOctaves[start + i]);
+
+            for (int i = 0; i < count; i++)
+                resonances[(size_t) i] = resonance += resonanceStep;
+
+            filterVaryingChunk(channels, numChannels, start, count, parameters);
+            }
+
+        endModulation(numSamples);
+    }
+
+    //Control-rate modulation: one table lookup for the whole call, and the pole coefficient
+    //and resonance move linearly from where they were to the offset values by the last sample.
+    void processRamped(float* const* channels, int numChannels, int numSamples, float offsetOctaves, float resonanceOffset) noexcept
+    {
+        if (numSamples <= 0 || cutoffTable == nullptr)
+            return;
+
+        numChannels = std::min(numChannels, (int) state.size());
+        const auto parameters = getLoopParameters();
+        auto pole = poleRamp.current;
+        auto resonance = resonanceRamp.current;
+        const auto poleStep = (cutoffTable->getCoefficientForOctave(octaveRamp.skip(numSamples) + offsetOctaves) - pole) / (float) numSamples;
+        const auto resonanceStep = (getModulatedResonance(numSamples, resonanceOffset) - resonance) / (float) numSamples;
+
+        for (int start = 0; start < numSamples; start += chunkSize) {
+            const auto count = std::min((int) chunkSize, numSamples - start);
+
+            for (int i = 0; i < count; i++) {
+                poles[(size_t) i] = pole += poleStep;
+                resonances[(size_t) i] = resonance += resonanceStep;
+                }
+
+            filterVaryingChunk(channels, numChannels, start, count, parameters);
+            }
+
+        endModulation(numSamples);
+    }
+
+private:
+
+    using State = std::array<float, 5>;
+
+    //matches juce::SmoothedValue<float, Linear>
+    struct LinearRamp
+    {
+        float current = 0.0f, target = 0.0f, step = 0.0f;
+        int countdown = 0, steps = 0;
+
+        void reset(int newSteps) noexcept { steps = newSteps; snap(); }
+        void snap() noexcept { current = target; countdown = 0; }
+        bool isRamping() const noexcept { return countdown > 0; }
+
+        void setTarget(float newTarget) noexcept
+        {
+            if (newTarget == target)
+                return;
+
+            if (steps <= 0) {
+                current = target = newTarget;
+                countdown = 0;
+                return;
+                }
+
+            target = newTarget;
+            countdown = steps;
+            step = (target - current) / (float) countdown;
+        }
+
+        //moves numSamples along the ramp at once
+        float skip(int numSamples) noexcept
+        {
+            if (countdown > numSamples) {
+                countdown -= numSamples;
+                current += step * (float) numSamples;
+                }
+            else {
+                snap();
+                }
+
+            return current;
+        }
+
+        //restarts the ramp to the same target from somewhere else
+        void glideFrom(float value) noexcept
+        {
+            current = value;
+            countdown = steps > 0 && current != target ? steps : 0;
+            step = countdown > 0 ? (target - current) / (float) countdown : 0.0f;
+        }
+
+        float next() noexcept
+        {
+            if (countdown <= 0)
+                return target;
+
+            --countdown;
+            current = countdown > 0 ? current + step : target;
+            return current;
+        }
+    };
+
+    static float scaleResonance(float resonance) noexcept { return 0.1f + 0.9f * resonance; }
+
+    float getModulatedResonance(int numSamples, float offset) noexcept
+    {
+        return scaleResonance(std::min(1.0f, std::max(0.0f, baseResonanceRamp.skip(numSamples) + offset)));
+    }
+
+    //glide from the last modulated values, so dropping the modulation doesn't click
+    void endModulation(int numSamples) noexcept
+    {
+        const auto last = (size_t) ((numSamples - 1) % chunkSize);
+        poleRamp.glideFrom(poles[last]);
+        resonanceRamp.glideFrom(resonances[last]);
+    }
+
+    LadderLoopParameters getLoopParameters() const noexcept
+    {
+        return { saturation->getTanhValues(), drive, drive2, gain, gain2 };
+    }
+
+    //the coefficients are in poles and resonances
+    void filterVaryingChunk(float* const* channels, int numChannels, int start, int count, const LadderLoopParameters& parameters) noexcept
+    {
+        filterChunk(channels, numChannels, start, count, [&] (Mode loopMode, float* data, float* channelState) {
+            kernels->ladderVarying[(size_t) loopMode](data, count, channelState, parameters, poles.data(), resonances.data());
+        });
+    }
+
+    //runLoop(mode, data, state) filters count samples of one channel in the given mode
+    template <typename RunLoop>
+    void filterChunk(float* const* channels, int numChannels, int start, int count, RunLoop&& runLoop) noexcept
+    {
+        if (fadeRemaining <= 0) {
+            for (int channel = 0; channel < numChannels; channel++)
+                runLoop(mode, channels[channel] + start, state[(size_t) channel].data());
+
+            return;
+            }
+
+        //run the outgoing mode on a copy of the input, then fade it into the new mode's output
+        const auto fadeStart = fadeLength - fadeRemaining;
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            auto* data = channels[channel] + start;
+            auto* faded = fadeScratch[(size_t) channel].data();
+
+            std::copy(data, data + count, faded);
+            runLoop(fadeMode, faded, fadeState[(size_t) channel].data());
+            runLoop(mode, data, state[(size_t) channel].data());
+
+            for (int i = 0; i < count; i++) {
+                const auto amount = std::min(1.0f, (float) (fadeStart + i + 1) / (float) fadeLength);
+                data[i] = faded[i] + amount * (data[i] - faded[i]);
+                }
+            }
+
+        fadeRemaining -= count;
+    }
+
+    //coefficients are worked out this many samples at a time, so no buffer depends on the host block size
+    //(copied before std::min takes it by reference, this header has no .cpp to define it in for C++14)
+    static constexpr int chunkSize = 256;
+
+    std::shared_ptr<const SaturationTable> saturation;
+    std::shared_ptr<const CutoffTable> cutoffTable;
+    const DspKernels* kernels;
+    double sampleRate = 1000.0;
+
+    Mode mode = Mode::LPF12;
+    float cutoffHz = 200.0f;
+    float drive = 1.0f, drive2 = 1.0f, gain = 1.0f, gain2 = 1.0f;
+
+    //poleRamp and resonanceRamp hold the values in use, the modulated paths add their offsets
+    //to octaveRamp and baseResonanceRamp
+    LinearRamp poleRamp, resonanceRamp, octaveRamp, baseResonanceRamp;
+    std::array<float, chunkSize> poles {}, resonances {};
+    std::vector<State> state;
+
+    //the outgoing mode during a crossfade
+    Mode fadeMode = Mode::LPF12;
+    int fadeLength = 1, fadeRemaining = 0;
+    std::vector<State> fadeState;
+    std::vector<std::array<float, chunkSize>> fadeScratch;
+};
@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+    LadderLanes.h
+
+    Several independent drive -> ladder -> trim chains run side by side, one
+    per lane. Samples arrive as frames of numLanes floats, and each group of
+    four lanes is stepped through the chain with one SIMD instruction per
+    operation (LaneSimd.h). The saturation curves are the rational
+    approximations in LaneMath rather than the shared tables, since table
+    lookups can't be vectorised.
+
+    Settings are smoothed over 50 ms like the single chain: the drive gains
+    multiplicatively, the rest linearly. Within a chunk they are
+    interpolated linearly, and the interpolation is skipped entirely once
+    every lane has settled.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "LadderKernel.h"
+#include "LaneSimd.h"
+#include "NoDenormals.h"
+
+template <int numLanes>
+class LadderLanes
+{
+public:
+    static_assert(numLanes % Float4::size == 0, "lanes come in groups of four");
+
+    //the same controls as the plugin's single chain
+    struct Settings
+    {
+        float drive = 0.0f;
+        float cutoff = 750.0f;
+        float resonance = 0.5f;
+        float trimDecibels = 0.0f;
+        LadderKernel::Mode mode = LadderKernel::Mode::LPF12;
+
+        bool operator== (const Settings& other) const noexcept
+        {
+            return drive == other.drive && cutoff == other.cutoff && resonance == other.resonance
+                && trimDecibels == other.trimDecibels && mode == other.mode;
+        }
+    };
+
+    static constexpr int lanes = numLanes;
+
+    LadderLanes()
+    {
+        for (int lane = 0; lane < numLanes; lane++)
+            updateLane(lane);
+
+        snap();
+    }
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        rampSteps = std::max(1, (int) std::floor(0.05 * sampleRate));
+
+        for (int lane = 0; lane < numLanes; lane++)
+            updateLane(lane);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& group : state)
+            group.fill(broadcast(0.0f));
+
+        snap();
+    }
+
+    //Cheap to call every block, the targets are only worked out again when something changed
+    void setLane(int lane, const Settings& newSettings) noexcept
+    {
+        if (newSettings == settings[(size_t) lane])
+            return;
+
+        settings[(size_t) lane] = newSettings;
+        updateLane(lane);
+    }
+
+    //frames holds numSamples frames of numLanes floats, processed in place with denormals flushed to zero
+    void process(float* frames, int numSamples) noexcept
+    {
+        NoDenormals noDenormals;
+
+        for (int start = 0; start < numSamples; start += chunkSize) {
+            const auto count = std::min(chunkSize, numSamples - start);
+            auto* chunk = frames + (size_t) start * numLanes;
+
+            if (isRamping()) {
+                advanceRamps(count);
+                run<true>(chunk, count);
+                }
+            else {
+                run<false>(chunk, count);
+                }
+            }
+    }
+
+private:
+
+    enum Parameter : size_t
+    {
+        inputGain, outputGain, pole, resonance, trimGain, compensation,
+        tap0, tap1, tap2, tap3, tap4,
+        numParameters
+    };
+
+    using Lanes = std::array<float, numLanes>;
+
+    //works out a lane's targets, which are reached 50 ms later
+    void updateLane(int lane) noexcept
+    {
+        const auto& newSettings = settings[(size_t) lane];
+
+        //the plugin's softClip gains
+        const auto drive = newSettings.drive * 5.0f;
+        const auto tapMix = LadderKernel::getTapMix(newSettings.mode);
+        const auto l = (size_t) lane;
+
+        targets[inputGain][l] = std::pow(10.0f, drive * 0.05f);
+        targets[outputGain][l] = 0.63661977236f * 1.5f * std::pow(10.0f, -drive * 0.04f);
+        targets[pole][l] = std::exp(newSettings.cutoff * float (-2.0 * 3.14159265358979323846 / sampleRate));
+        targets[resonance][l] = 0.1f + 0.9f * newSettings.resonance;
+        targets[trimGain][l] = std::pow(10.0f, newSettings.trimDecibels * 0.05f);
+        targets[compensation][l] = tapMix.compensation;
+
+        for (size_t tap = 0; tap < 5; tap++)
+            targets[tap0 + tap][l] = tapMix.taps[tap];
+
+        bool changed = false;
+
+        for (size_t parameter = 0; parameter < numParameters; parameter++) {
+            //the drive gains as a ratio per sample, like juce::SmoothedValue's multiplicative ramp
+            if (isMultiplicative(parameter)) {
+                steps[parameter][l] = std::exp((std::log(targets[parameter][l]) - std::log(values[parameter][l])) / (float) rampSteps);
+                changed = changed || targets[parameter][l] != values[parameter][l];
+                }
+            else {
+                steps[parameter][l] = (targets[parameter][l] - values[parameter][l]) / (float) rampSteps;
+                changed = changed || steps[parameter][l] != 0.0f;
+                }
+            }
+
+        countdown[l] = changed ? rampSteps : 0;
+    }
+
+    static constexpr bool isMultiplicative(size_t parameter) noexcept { return parameter == inputGain || parameter == outputGain; }
+
+    bool isRamping() const noexcept
+    {
+        for (auto remaining : countdown)
+            if (remaining > 0)
+                return true;
+
+        return false;
+    }
+
+    void snap() noexcept
+    {
+        values = targets;
+        chunkStart = targets;
+        countdown.fill(0);
+
+        for (auto& parameter : deltas)
+            parameter.fill(0.0f);
+    }
+
+    //moves every ramp count samples on, and sets up the linear path from where it was
+    void advanceRamps(int count) noexcept
+    {
+        chunkStart = values;
+
+        for (size_t l = 0; l < (size_t) numLanes; l++) {
+            const auto advance = std::min(count, countdown[l]);
+            countdown[l] -= advance;
+
+            for (size_t parameter = 0; parameter < numParameters; parameter++) {
+                if (countdown[l] == 0)
+                    values[parameter][l] = targets[parameter][l];
+                else if (isMultiplicative(parameter))
+                    values[parameter][l] *= std::pow(steps[parameter][l], (float) advance);
+                else
+                    values[parameter][l] += steps[parameter][l] * (float) advance;
+
+                deltas[parameter][l] = (values[parameter][l] - chunkStart[parameter][l]) / (float) count;
+                }
+            }
+    }
+
+    template <bool ramping>
+    void run(float* frames, int count) noexcept
+    {
+        const auto& p = ramping ? chunkStart : values;
+
+        //one group of four lanes at a time, so its state stays in registers for the whole chunk
+        for (size_t group = 0; group < (size_t) numGroups; group++) {
+            const auto offset = group * Float4::size;
+            auto s = state[group];
+            Float4 c[numParameters], d[numParameters];
+
+            for (size_t parameter = 0; parameter < numParameters; parameter++) {
+                c[parameter] = load(p[parameter].data() + offset);
+                d[parameter] = load(deltas[parameter].data() + offset);
+                }
+
+            for (int i = 0; i < count; i++) {
+                auto* frame = frames + (size_t) i * numLanes + offset;
+
+                if (ramping)
+                    for (size_t parameter = 0; parameter < numParameters; parameter++)
+                        c[parameter] = c[parameter] + d[parameter];
+
+                const auto x = LaneMath::atan(c[inputGain] * load(frame)) * c[outputGain];
+
+                const auto a1 = c[pole];
+                const auto g = 1.0f - a1;
+                const auto b0 = g * 0.76923076923f;
+                const auto b1 = g * 0.23076923076f;
+
+                //the kernel's ladder at a ladder drive of 1, where drive2 is 1 and both gains are 1.0006
+                const auto dx = LaneMath::tanh(x) * ladderGain;
+                const auto a = dx + c[resonance] * -4.0f * (LaneMath::tanh(s[4]) * ladderGain - dx * c[compensation]);
+                const auto b = b1 * s[0] + a1 * s[1] + b0 * a;
+                const auto cc = b1 * s[1] + a1 * s[2] + b0 * b;
+                const auto e3 = b1 * s[2] + a1 * s[3] + b0 * cc;
+                const auto e4 = b1 * s[3] + a1 * s[4] + b0 * e3;
+
+                s = {{ a, b, cc, e3, e4 }};
+
+                store(frame, (a * c[tap0] + b * c[tap1] + cc * c[tap2] + e3 * c[tap3] + e4 * c[tap4]) * c[trimGain]);
+                }
+
+            state[group] = s;
+            }
+    }
+
+    //settings are interpolated linearly over at most this many samples
+    static constexpr int chunkSize = 32;
+    static constexpr float ladderGain = 0.6103f + 0.3903f;
+
+    double sampleRate = 44100.0;
+    int rampSteps = 1;
+
+    std::array<Settings, numLanes> settings;
+    std::array<Lanes, numParameters> values {}, targets {}, steps {}, deltas {}, chunkStart {};
+    std::array<int, numLanes> countdown {};
+    static constexpr int numGroups = numLanes / Float4::size;
+    std::array<std::array<Float4, 5>, numGroups> state;
+};
+
+template <int numLanes>
+constexpr int LadderLanes<numLanes>::chunkSize;
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    LaneSimd.h
+
+    Four floats processed as one: SSE2 on x86, NEON on 64-bit ARM, and plain
+    arrays anywhere else. Only covers the operations the lane processors
+    need. Kept free of JUCE so the DSP can be built on its own.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define LADDER_LANES_SSE2 1
+ #include <emmintrin.h>
+#elif defined (__aarch64__) || defined (_M_ARM64)
+ #define LADDER_LANES_NEON 1
+ #include <arm_neon.h>
+#endif
+
+struct Float4
+{
+   #if LADDER_LANES_SSE2
+    __m128 v;
+   #elif LADDER_LANES_NEON
+    float32x4_t v;
+   #else
+    float v[4];
+   #endif
+
+    static constexpr int size = 4;
+};
+
+#if LADDER_LANES_SSE2
+
+inline Float4 broadcast(float x) noexcept                        { return { _mm_set1_ps(x) }; }
+inline Float4 load(const float* p) noexcept                      { return { _mm_loadu_ps(p) }; }
+inline void store(float* p, Float4 a) noexcept                   { _mm_storeu_ps(p, a.v); }
+inline Float4 operator+ (Float4 a, Float4 b) noexcept            { return { _mm_add_ps(a.v, b.v) }; }
+inline Float4 operator- (Float4 a, Float4 b) noexcept            { return { _mm_sub_ps(a.v, b.v) }; }
+inline Float4 operator* (Float4 a, Float4 b) noexcept            { return { _mm_mul_ps(a.v, b.v) }; }
+inline Float4 operator/ (Float4 a, Float4 b) noexcept            { return { _mm_div_ps(a.v, b.v) }; }
+inline Float4 min(Float4 a, Float4 b) noexcept                   { return { _mm_min_ps(a.v, b.v) }; }
+inline Float4 max(Float4 a, Float4 b) noexcept                   { return { _mm_max_ps(a.v, b.v) }; }
+inline Float4 abs(Float4 a) noexcept                             { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+
+//a with the sign of b
+inline Float4 copySign(Float4 a, Float4 b) noexcept
+{
+    const auto signBit = _mm_set1_ps(-0.0f);
+    return { _mm_or_ps(_mm_andnot_ps(signBit, a.v), _mm_and_ps(signBit, b.v)) };
+}
+
+//a > b ? ifGreater : otherwise, per lane
+inline Float4 selectGreater(Float4 a, Float4 b, Float4 ifGreater, Float4 otherwise) noexcept
+{
+    const auto mask = _mm_cmpgt_ps(a.v, b.v);
+    return { _mm_or_ps(_mm_and_ps(mask, ifGreater.v), _mm_andnot_ps(mask, otherwise.v)) };
+}
+
+#elif LADDER_LANES_NEON
+
+inline Float4 broadcast(float x) noexcept                        { return { vdupq_n_f32(x) }; }
+inline Float4 load(const float* p) noexcept                      { return { vld1q_f32(p) }; }
+inline void store(float* p, Float4 a) noexcept                   { vst1q_f32(p, a.v); }
+inline Float4 operator+ (Float4 a, Float4 b) noexcept            { return { vaddq_f32(a.v, b.v) }; }
+inline Float4 operator- (Float4 a, Float4 b) noexcept            { return { vsubq_f32(a.v, b.v) }; }
+inline Float4 operator* (Float4 a, Float4 b) noexcept            { return { vmulq_f32(a.v, b.v) }; }
+inline Float4 operator/ (Float4 a, Float4 b) noexcept            { return { vdivq_f32(a.v, b.v) }; }
+inline Float4 min(Float4 a, Float4 b) noexcept                   { return { vminq_f32(a.v, b.v) }; }
+inline Float4 max(Float4 a, Float4 b) noexcept                   { return { vmaxq_f32(a.v, b.v) }; }
+inline Float4 abs(Float4 a) noexcept                             { return { vabsq_f32(a.v) }; }
+
+inline Float4 copySign(Float4 a, Float4 b) noexcept
+{
+    const auto signBit = vdupq_n_u32(0x80000000u);
+    return { vbslq_f32(signBit, b.v, a.v) };
+}
+
+inline Float4 selectGreater(Float4 a, Float4 b, Float4 ifGreater, Float4 otherwise) noexcept
+{
+    return { vbslq_f32(vcgtq_f32(a.v, b.v), ifGreater.v, otherwise.v) };
+}
+
+#else
+
+inline Float4 broadcast(float x) noexcept                        { return {{ x, x, x, x }}; }
+inline Float4 load(const float* p) noexcept                      { Float4 r; std::memcpy(r.v, p, sizeof (r.v)); return r; }
+inline void store(float* p, Float4 a) noexcept                   { std::memcpy(p, a.v, sizeof (a.v)); }
+
+#define LADDER_LANES_SCALAR_OP(expression) \
+    Float4 r; for (int i = 0; i < 4; i++) r.v[i] = expression; return r;
+
+inline Float4 operator+ (Float4 a, Float4 b) noexcept            { LADDER_LANES_SCALAR_OP (a.v[i] + b.v[i]) }
+inline Float4 operator- (Float4 a, Float4 b) noexcept            { LADDER_LANES_SCALAR_OP (a.v[i] - b.v[i]) }
+inline Float4 operator* (Float4 a, Float4 b) noexcept            { LADDER_LANES_SCALAR_OP (a.v[i] * b.v[i]) }
+inline Float4 operator/ (Float4 a, Float4 b) noexcept            { LADDER_LANES_SCALAR_OP (a.v[i] / b.v[i]) }
+inline Float4 min(Float4 a, Float4 b) noexcept                   { LADDER_LANES_SCALAR_OP (b.v[i] < a.v[i] ? b.v[i] : a.v[i]) }
+inline Float4 max(Float4 a, Float4 b) noexcept                   { LADDER_LANES_SCALAR_OP (a.v[i] < b.v[i] ? b.v[i] : a.v[i]) }
+inline Float4 abs(Float4 a) noexcept                             { LADDER_LANES_SCALAR_OP (std::abs(a.v[i])) }
+inline Float4 copySign(Float4 a, Float4 b) noexcept              { LADDER_LANES_SCALAR_OP (std::copysign(a.v[i], b.v[i])) }
+
+inline Float4 selectGreater(Float4 a, Float4 b, Float4 ifGreater, Float4 otherwise) noexcept
+{
+    LADDER_LANES_SCALAR_OP (a.v[i] > b.v[i] ? ifGreater.v[i] : otherwise.v[i])
+}
+
+#undef LADDER_LANES_SCALAR_OP
+
+#endif
+
+inline Float4 operator+ (Float4 a, float b) noexcept             { return a + broadcast(b); }
+inline Float4 operator+ (float a, Float4 b) noexcept             { return broadcast(a) + b; }
+inline Float4 operator* (Float4 a, float b) noexcept             { return a * broadcast(b); }
+inline Float4 operator* (float a, Float4 b) noexcept             { return broadcast(a) * b; }
+inline Float4 operator- (float a, Float4 b) noexcept             { return broadcast(a) - b; }
+
+namespace LaneMath
+{
+    //Lambert's continued fraction, within 1e-4 of tanh up to the clamp where it reaches 1
+    inline Float4 tanh(Float4 x) noexcept
+    {
+        x = min(broadcast(4.97f), max(broadcast(-4.97f), x));
+        const auto x2 = x * x;
+        return x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)))
+                 / (135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f)));
+    }
+
+    //Abramowitz & Stegun 4.4.49 on [0, 1], within 2e-6 of atan, with atan(x) = pi/2 - atan(1/x) above it
+    inline Float4 atan(Float4 x) noexcept
+    {
+        const auto one = broadcast(1.0f);
+        const auto magnitude = abs(x);
+        const auto z = min(magnitude, one / magnitude);
+        const auto z2 = z * z;
+        const auto p = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+        return copySign(selectGreater(magnitude, one, 1.57079632679f - p, p), x);
+    }
+}
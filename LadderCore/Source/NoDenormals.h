@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    NoDenormals.h
+
+    juce::ScopedNoDenormals for the JUCE-free code: while one exists, the
+    FPU flushes denormals to zero (FTZ and DAZ on x86, FZ on 64-bit ARM),
+    and the previous mode is put back when it goes. A decaying filter tail
+    otherwise spends up to a hundred times longer per sample once its state
+    drops below 1e-38. Does nothing on other targets.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#if defined (__SSE__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 1)
+ #define LADDER_DENORMALS_SSE 1
+ #include <xmmintrin.h>
+#elif defined (__aarch64__)
+ #define LADDER_DENORMALS_ARM64 1
+#endif
+
+class NoDenormals
+{
+public:
+    NoDenormals() noexcept
+    {
+       #if LADDER_DENORMALS_SSE
+        previous = _mm_getcsr();
+        _mm_setcsr((unsigned int) previous | 0x8040);
+       #elif LADDER_DENORMALS_ARM64
+        asm volatile ("mrs %0, fpcr" : "=r" (previous));
+        asm volatile ("msr fpcr, %0" : : "r" (previous | (1ull << 24)));
+       #endif
+    }
+
+    ~NoDenormals() noexcept
+    {
+       #if LADDER_DENORMALS_SSE
+        _mm_setcsr((unsigned int) previous);
+       #elif LADDER_DENORMALS_ARM64
+        asm volatile ("msr fpcr, %0" : : "r" (previous));
+       #endif
+    }
+
+    NoDenormals(const NoDenormals&) = delete;
+    NoDenormals& operator= (const NoDenormals&) = delete;
+
+private:
+    uint64_t previous = 0;
+};
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    PrepareCache.h
+
+    The last few configurations a host asked for, each holding its rate's
+    CutoffTable so that switching back to that rate rebuilds nothing.
+    SharedTables holds tables weakly, so without a reference here an
+    instance that leaves a rate drops its table and builds it again when it
+    comes back.
+
+    The table is all that's kept. Configurations also carry the maximum
+    block size and channel count, so a host's configurations are told apart
+    and counted, but entries that differ only in those hold the same table.
+    Channel state isn't cached: the kernel reuses it in place while the
+    channel count is unchanged and reallocates it otherwise. Call prepare()
+    before the processors are prepared so they find the table already
+    built. Not thread-safe, use it from the thread that prepares.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "SharedTables.h"
+
+class PrepareCache
+{
+public:
+    struct Configuration
+    {
+        double sampleRate;
+        int maximumBlockSize, numChannels;
+
+        bool operator== (const Configuration& other) const noexcept
+        {
+            return sampleRate == other.sampleRate && maximumBlockSize == other.maximumBlockSize && numChannels == other.numChannels;
+        }
+    };
+
+    //What releaseResources() gives back:
+    //keepEverything   nothing, the next prepare is the quickest
+    //freeBuffers      the kernels' per-channel state, cached tables stay
+    //freeEverything   that and the cache's tables
+    //LadderLanes keeps its state inline, so for chains built from lanes the last two are the same.
+    enum class ReleasePolicy { keepEverything, freeBuffers, freeEverything };
+
+    explicit PrepareCache(int maxConfigurations = 4) : capacity(std::max(1, maxConfigurations)) {}
+
+    //Not real-time safe. Makes the configuration the newest, dropping the oldest if the cache is full.
+    //Returns true if it was already cached.
+    bool prepare(const Configuration& configuration)
+    {
+        const auto found = std::find_if(entries.begin(), entries.end(), [&] (const Entry& entry) { return entry.configuration == configuration; });
+
+        if (found != entries.end()) {
+            std::rotate(entries.begin(), found, found + 1);
+            return true;
+            }
+
+        if ((int) entries.size() == capacity)
+            entries.pop_back();
+
+        entries.insert(entries.begin(), { configuration, SharedTables::getCutoff(configuration.sampleRate) });
+        return false;
+    }
+
+    bool contains(const Configuration& configuration) const noexcept
+    {
+        return std::any_of(entries.begin(), entries.end(), [&] (const Entry& entry) { return entry.configuration == configuration; });
+    }
+
+    int size() const noexcept { return (int) entries.size(); }
+
+    //tables still held by a prepared processor live on until it lets them go
+    void clear() noexcept
+    {
+        std::vector<Entry>().swap(entries);
+    }
+
+private:
+
+    struct Entry
+    {
+        Configuration configuration;
+        std::shared_ptr<const CutoffTable> cutoffTable;
+    };
+
+    int capacity;
+
+    //newest first
+    std::vector<Entry> entries;
+};
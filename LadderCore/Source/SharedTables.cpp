@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    SharedTables.cpp
+
+  ==============================================================================
+*/
+
+#include "SharedTables.h"
+#include <map>
+#include <mutex>
+
+SaturationTable::SaturationTable()
+{
+    atanValues.resize(size + 2);
+    tanhValues.resize(size + 2);
+    
+    for (int i = 0; i <= size; i++) {
+        atanValues[i] = (float) std::atan(i / double (size));
+        tanhValues[i] = (float) std::tanh(i * (tanhRange / double (size)));
+        }
+    
+    atanValues[size + 1] = atanValues[size];
+    tanhValues[size + 1] = tanhValues[size];
+}
+
+//definitions for the constants passed by reference, C++14 has no inline variables
+constexpr float CutoffTable::minCutoff;
+
+CutoffTable::CutoffTable(double rate) : sampleRate(rate)
+{
+    //up to Nyquist, plus the guard point
+    const auto numOctaves = std::log2(0.5 * sampleRate / minCutoff);
+    const auto numPoints = (int) std::ceil(numOctaves * pointsPerOctave) + 2;
+    
+    coefficients.resize(numPoints);
+    
+    for (int i = 0; i < numPoints; i++) {
+        auto cutoff = minCutoff * std::pow(2.0, i / double (pointsPerOctave));
+        coefficients[i] = (float) std::exp(-2.0 * 3.14159265358979323846 * cutoff / sampleRate);
+        }
+}
+
+std::shared_ptr<const SaturationTable> SharedTables::getSaturation()
+{
+    //built once, on first use, thread-safe by the language rules
+    static const auto table = std::make_shared<const SaturationTable>();
+    return table;
+}
+
+std::shared_ptr<const CutoffTable> SharedTables::getCutoff(double sampleRate)
+{
+    static std::mutex lock;
+    static std::map<double, std::weak_ptr<const CutoffTable>> tables;
+    
+    std::lock_guard<std::mutex> guard (lock);
+    auto& entry = tables[sampleRate];
+    auto table = entry.lock();
+    
+    if (table == nullptr) {
+        table = std::make_shared<const CutoffTable>(sampleRate);
+        entry = table;
+        }
+    
+    return table;
+}
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    SharedTables.h
+
+    Read-only lookup tables shared by every plugin instance in the process.
+    Tables are built the first time they are asked for and never change
+    afterwards, so the audio thread can read them through a plain pointer.
+    Ask for them from the constructor or prepareToPlay, never from
+    processBlock - the registry takes a lock.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/** atan and tanh sampled on a uniform grid, read with linear interpolation. */
+class SaturationTable
+{
+public:
+    SaturationTable();
+
+    float atan(float x) const noexcept
+    {
+        const auto magnitude = std::abs(x);
+
+        //atan(x) = pi/2 - atan(1/x) keeps the table on [0, 1] for any input
+        if (magnitude <= 1.0f)
+            return std::copysign(lookup(atanValues, magnitude * size), x);
+
+        if (magnitude < std::numeric_limits<float>::infinity())
+            return std::copysign(halfPi - lookup(atanValues, size / magnitude), x);
+
+        return std::copysign(halfPi, x);
+    }
+
+    float tanh(float x) const noexcept
+    {
+        const auto magnitude = std::abs(x);
+
+        if (magnitude < tanhRange)
+            return std::copysign(lookup(tanhValues, magnitude * (size / tanhRange)), x);
+
+        return std::copysign(1.0f, x);
+    }
+
+    //the raw tables for the DspKernels loops, size + 2 values each
+    const float* getAtanValues() const noexcept { return atanValues.data(); }
+    const float* getTanhValues() const noexcept { return tanhValues.data(); }
+
+    static constexpr int size = 4096;
+    static constexpr float tanhRange = 9.0f;
+
+private:
+
+    static float lookup(const std::vector<float>& values, float position) noexcept
+    {
+        const auto index = (int) position;
+        const auto fraction = position - (float) index;
+        return values[index] + fraction * (values[index + 1] - values[index]);
+    }
+
+    static constexpr float halfPi = 1.57079632679489661923f;
+
+    //one guard point past the end so lookup() can always read index + 1
+    std::vector<float> atanValues, tanhValues;
+};
+
+//==============================================================================
+/** The ladder's one-pole coefficient exp(-2 pi fc / fs) for one sample rate,
+    sampled in octaves so modulation in the pitch domain is a straight lookup. */
+class CutoffTable
+{
+public:
+    CutoffTable(double sampleRate);
+
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    //octave is log2(cutoff / minCutoff)
+    float getCoefficientForOctave(float octave) const noexcept
+    {
+        const auto position = std::min((float) (coefficients.size() - 2), std::max(0.0f, octave * pointsPerOctave));
+        const auto index = (int) position;
+        const auto fraction = position - (float) index;
+        return coefficients[index] + fraction * (coefficients[index + 1] - coefficients[index]);
+    }
+
+    float getCoefficient(float cutoffHz) const noexcept
+    {
+        return getCoefficientForOctave(std::log2(std::max(cutoffHz, minCutoff) / minCutoff));
+    }
+
+    static constexpr float minCutoff = 10.0f;
+    static constexpr int pointsPerOctave = 128;
+
+private:
+
+    double sampleRate;
+    std::vector<float> coefficients;
+};
+
+//==============================================================================
+/** Process-wide registry of the tables above. */
+namespace SharedTables
+{
+    std::shared_ptr<const SaturationTable> getSaturation();
+
+    //one table per sample rate, kept alive as long as an instance holds it
+    std::shared_ptr<const CutoffTable> getCutoff(double sampleRate);
+}
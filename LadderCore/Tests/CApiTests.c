@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    CApiTests.c
+
+    The C API from plain C through the shared library: status codes,
+    clamping and a processed block.
+
+  ==============================================================================
+*/
+
+#include "LadderCore.h"
+#include <math.h>
+#include <stdio.h>
+
+static int failures = 0;
+
+#define EXPECT(condition) \
+    do { if (! (condition)) { printf ("FAILED %s:%d: %s\n", __FILE__, __LINE__, #condition); ++failures; } } while (0)
+
+int main(void)
+{
+    float left[512], right[512], value = 0.0f;
+    float* channels[2];
+    int i;
+    ladder_engine* engine = ladder_create();
+
+    channels[0] = left;
+    channels[1] = right;
+
+    EXPECT(engine != NULL);
+    EXPECT(ladder_core_api_version() == LADDER_CORE_API_VERSION);
+    EXPECT(ladder_process(engine, channels, 2, 512) == LADDER_ERROR_NOT_PREPARED);
+    EXPECT(ladder_process(NULL, channels, 2, 512) == LADDER_ERROR_INVALID_ARGUMENT);
+    EXPECT(ladder_prepare(engine, 0.0, 2) == LADDER_ERROR_INVALID_ARGUMENT);
+
+    EXPECT(ladder_prepare(engine, 48000.0, 2) == LADDER_OK);
+    EXPECT(ladder_set_param(engine, LADDER_PARAM_DRIVE, 3.0f) == LADDER_OK);
+    EXPECT(ladder_set_param(engine, LADDER_PARAM_CUTOFF, 50000.0f) == LADDER_OK);
+    EXPECT(ladder_get_param(engine, LADDER_PARAM_CUTOFF, &value) == LADDER_OK && value == 20000.0f);
+    EXPECT(ladder_set_param(engine, (ladder_param) 99, 1.0f) == LADDER_ERROR_INVALID_ARGUMENT);
+    EXPECT(ladder_process(engine, channels, 3, 512) == LADDER_ERROR_INVALID_ARGUMENT);
+
+    for (i = 0; i < 512; i++) {
+        left[i] = 0.5f * sinf ((float) i * 0.05f);
+        right[i] = -left[i];
+    }
+
+    EXPECT(ladder_process(engine, channels, 2, 512) == LADDER_OK);
+    EXPECT(left[511] != 0.0f && fabsf (left[511] + right[511]) < 1.0e-6f);
+
+    ladder_reset(engine);
+    ladder_destroy(engine);
+    ladder_destroy(NULL);
+
+    printf("CApiTests: %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    DispatchTests.cpp
+
+    Every instruction set this machine can run against the scalar kernels:
+    each loop on its own, then the whole engine with the set forced. The
+    scalar saturation is checked against SaturationTable itself. Sets that
+    weren't built or that the CPU lacks are reported and skipped.
+
+  ==============================================================================
+*/
+
+#include "LadderEngine.h"
+#include "TestHelpers.h"
+#include <random>
+
+namespace
+{
+    constexpr int numSamples = 4096;
+
+    std::vector<float> makeNoise(float level, unsigned int seed)
+    {
+        std::mt19937 random (seed);
+        std::uniform_real_distribution<float> noise (-level, level);
+        std::vector<float> signal (numSamples);
+
+        for (auto& sample : signal)
+            sample = noise(random);
+
+        return signal;
+    }
+
+    //including values past the table ends, infinities and a NaN
+    std::vector<float> makeSaturationInput()
+    {
+        auto signal = makeNoise(4.0f, 1);
+        signal[0] = 0.0f;
+        signal[1] = 1.0f;
+        signal[2] = -1.0f;
+        signal[3] = 1.0e30f;
+        signal[4] = -INFINITY;
+        signal[5] = INFINITY;
+        signal[6] = 1.0e-30f;
+        signal[7] = -0.0f;
+        return signal;
+    }
+
+    double maxDifferenceIgnoringNaN(std::vector<float> a, std::vector<float> b)
+    {
+        for (size_t i = 0; i < a.size() && i < b.size(); i++)
+            if (std::isnan(a[i]) || std::isnan(b[i]))
+                a[i] = b[i] = 0.0f;
+
+        return TestHelpers::maxDifference(a, b);
+    }
+
+    void testScalarSaturation(const DspKernels& scalar)
+    {
+        const auto table = SharedTables::getSaturation();
+        auto input = makeSaturationInput();
+        input[8] = NAN;
+
+        auto processed = input;
+        scalar.saturate(processed.data(), numSamples, table->getAtanValues(), 2.0f, 0.5f);
+
+        auto expected = input;
+
+        for (auto& sample : expected)
+            sample = table->atan(2.0f * sample) * 0.5f;
+
+        //NaN reads a table value rather than giving pi/2, either is fine as long as it's finite
+        EXPECT(std::isfinite(processed[8]));
+        expected[8] = processed[8];
+
+        EXPECT_BELOW(TestHelpers::maxDifference(processed, expected), 1e-7);
+    }
+
+    void compareKernels(const DspKernels& kernels, const DspKernels& scalar)
+    {
+        const auto table = SharedTables::getSaturation();
+        const auto input = makeSaturationInput();
+        const auto gains = makeNoise(2.0f, 2);
+        const auto poles = makeNoise(1.0f, 3);
+        auto resonances = makeNoise(1.0f, 4);
+
+        std::vector<float> positivePoles (poles);
+
+        for (size_t i = 0; i < poles.size(); i++) {
+            positivePoles[i] = 0.5f + 0.49f * poles[i];
+            resonances[i] = 0.55f + 0.45f * resonances[i];
+            }
+
+        auto check = [&] (const char* name, double difference, double limit) {
+            std::printf("%s %s: ", CpuDispatch::getName(kernels.instructionSet), name);
+            EXPECT_BELOW(difference, limit);
+        };
+
+        auto run = [&] (const DspKernels& k, auto&& process) {
+            auto data = input;
+            process(k, data.data());
+            return data;
+        };
+
+        auto compare = [&] (const char* name, double limit, auto&& process) {
+            check(name, maxDifferenceIgnoringNaN(run(kernels, process), run(scalar, process)), limit);
+        };
+
+        compare("saturate", 1e-6, [&] (const DspKernels& k, float* data) { k.saturate(data, numSamples, table->getAtanValues(), 3.0f, 0.7f); });
+        compare("saturateRamped", 1e-6, [&] (const DspKernels& k, float* data) { k.saturateRamped(data, numSamples, table->getAtanValues(), gains.data(), gains.data()); });
+        compare("applyGain", 1e-6, [&] (const DspKernels& k, float* data) { k.applyGain(data, numSamples, 0.25f); });
+        compare("applyGains", 1e-6, [&] (const DspKernels& k, float* data) { k.applyGains(data, numSamples, gains.data()); });
+
+        const LadderLoopParameters parameters { table->getTanhValues(), 1.0f, 1.0f * 0.04f + 0.96f, 1.0f, 1.0f };
+        const auto signal = makeNoise(0.9f, 5);
+
+        for (int mode = 0; mode < DspKernels::numModes; mode++) {
+            auto ladder = [&] (const DspKernels& k, bool varying) {
+                auto data = signal;
+                float state[5] = {};
+
+                //two calls, so the state carries across
+                for (int half = 0; half < 2; half++) {
+                    auto* block = data.data() + half * numSamples / 2;
+
+                    if (varying)
+                        k.ladderVarying[mode](block, numSamples / 2, state, parameters, positivePoles.data(), resonances.data());
+                    else
+                        k.ladderConstant[mode](block, numSamples / 2, state, parameters, 0.9f, 0.8f);
+                    }
+
+                return data;
+            };
+
+            check("ladderConstant", TestHelpers::maxDifference(ladder(kernels, false), ladder(scalar, false)), 1e-5);
+            check("ladderVarying", TestHelpers::maxDifference(ladder(kernels, true), ladder(scalar, true)), 1e-5);
+            }
+    }
+
+    std::vector<float> renderEngine(InstructionSet instructionSet)
+    {
+        CpuDispatch::force(instructionSet);
+
+        auto left = makeNoise(0.8f, 6);
+        auto right = makeNoise(0.8f, 7);
+
+        LadderEngine engine;
+        engine.prepare(48000.0, 2);
+        engine.setParameter(LadderEngine::Parameter::drive, 4.0f);
+        engine.setParameter(LadderEngine::Parameter::cutoff, 1500.0f);
+        engine.setParameter(LadderEngine::Parameter::resonance, 0.7f);
+        engine.setParameter(LadderEngine::Parameter::trim, -3.0f);
+
+        for (int start = 0; start < numSamples; start += 512) {
+            if (start == 2048)
+                engine.setParameter(LadderEngine::Parameter::mode, 4.0f);
+
+            float* channels[] = { left.data() + start, right.data() + start };
+            engine.process(channels, 2, 512);
+            }
+
+        CpuDispatch::clearForced();
+        left.insert(left.end(), right.begin(), right.end());
+        return left;
+    }
+}
+
+int main()
+{
+    InstructionSet parsed;
+    EXPECT(CpuDispatch::parse("avx2", parsed) && parsed == InstructionSet::avx2);
+    EXPECT(! CpuDispatch::parse("mmx", parsed));
+    EXPECT(CpuDispatch::isAvailable(InstructionSet::scalar));
+    EXPECT(CpuDispatch::isAvailable(CpuDispatch::getActive()));
+
+    const auto* scalar = CpuDispatch::getKernels(InstructionSet::scalar);
+    EXPECT(scalar != nullptr && scalar->instructionSet == InstructionSet::scalar);
+
+    if (scalar == nullptr)
+        return TestHelpers::finish("DispatchTests");
+
+    testScalarSaturation(*scalar);
+
+    const auto reference = renderEngine(InstructionSet::scalar);
+
+    for (auto instructionSet : CpuDispatch::allInstructionSets) {
+        const auto* kernels = CpuDispatch::getKernels(instructionSet);
+
+        if (kernels == nullptr) {
+            std::printf("%s: not available here\n", CpuDispatch::getName(instructionSet));
+            EXPECT(! CpuDispatch::force(instructionSet));
+            continue;
+            }
+
+        EXPECT(kernels->instructionSet == instructionSet);
+        compareKernels(*kernels, *scalar);
+
+        std::printf("%s engine: ", CpuDispatch::getName(instructionSet));
+        EXPECT_BELOW(TestHelpers::maxDifference(renderEngine(instructionSet), reference), 1e-5);
+        }
+
+    std::printf("best: %s, active: %s\n", CpuDispatch::getName(CpuDispatch::getBest()), CpuDispatch::getName(CpuDispatch::getActive()));
+    return TestHelpers::finish("DispatchTests");
+}
@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    EngineTests.cpp
+
+    LadderEngine's parameter handling, and its output against the chain it
+    stands in for: table atan saturation with the plugin's gains, then
+    LadderKernel, then the trim.
+
+  ==============================================================================
+*/
+
+#include "LadderEngine.h"
+#include "TestHelpers.h"
+
+namespace
+{
+    using Parameter = LadderEngine::Parameter;
+    constexpr double sampleRate = 48000.0;
+
+    std::vector<float> makeSines(int numSamples)
+    {
+        std::vector<float> signal ((size_t) numSamples);
+
+        for (size_t i = 0; i < signal.size(); i++)
+            signal[i] = 0.5f * (float) std::sin(2.0 * 3.14159265358979 * 220.0 * (double) i / sampleRate)
+                      + 0.3f * (float) std::sin(2.0 * 3.14159265358979 * 3100.0 * (double) i / sampleRate);
+
+        return signal;
+    }
+
+    void processInBlocks(LadderEngine& engine, std::vector<float>& left, std::vector<float>& right, int blockSize)
+    {
+        for (size_t offset = 0; offset < left.size(); offset += (size_t) blockSize) {
+            float* channels[] = { left.data() + offset, right.data() + offset };
+            engine.process(channels, 2, (int) std::min(left.size() - offset, (size_t) blockSize));
+            }
+    }
+
+    void testParameters()
+    {
+        LadderEngine engine;
+
+        for (int i = 0; i < LadderEngine::numParameters; i++) {
+            const auto parameter = (Parameter) i;
+            EXPECT(engine.getParameter(parameter) == LadderEngine::getDefault(parameter));
+
+            engine.setParameter(parameter, 1.0e6f);
+            EXPECT(engine.getParameter(parameter) == LadderEngine::getMaximum(parameter));
+
+            engine.setParameter(parameter, -1.0e6f);
+            EXPECT(engine.getParameter(parameter) == LadderEngine::getMinimum(parameter));
+
+            engine.setParameter(parameter, std::nanf(""));
+            EXPECT(engine.getParameter(parameter) == LadderEngine::getMinimum(parameter));
+            }
+
+        EXPECT(! engine.isPrepared());
+        engine.prepare(sampleRate, 2);
+        EXPECT(engine.isPrepared() && engine.getNumChannels() == 2);
+    }
+
+    void testUnpreparedAndSilence()
+    {
+        std::vector<float> left (512, 0.5f), right (512, 0.5f);
+        LadderEngine engine;
+        processInBlocks(engine, left, right, 512);
+        EXPECT(left[100] == 0.5f && right[511] == 0.5f);
+
+        //no DC offset or self-oscillation from silence, even at full resonance
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        engine.prepare(sampleRate, 2);
+        engine.setParameter(Parameter::resonance, 1.0f);
+        engine.setParameter(Parameter::drive, 10.0f);
+        processInBlocks(engine, left, right, 64);
+
+        double peak = 0.0;
+
+        for (size_t i = 0; i < left.size(); i++)
+            peak = std::max(peak, (double) std::max(std::abs(left[i]), std::abs(right[i])));
+
+        EXPECT(peak == 0.0);
+    }
+
+    //settled engine against the pieces it's built from
+    void testMatchesChain()
+    {
+        const int numSamples = 24000;
+        const float drive = 3.0f, cutoff = 1200.0f, resonance = 0.6f, trim = -6.0f;
+
+        auto left = makeSines(numSamples);
+        auto right = left;
+
+        LadderEngine engine;
+        engine.setParameter(Parameter::drive, drive);
+        engine.setParameter(Parameter::cutoff, cutoff);
+        engine.setParameter(Parameter::resonance, resonance);
+        engine.setParameter(Parameter::trim, trim);
+        engine.setParameter(Parameter::mode, 3.0f);
+        engine.prepare(sampleRate, 2);
+        processInBlocks(engine, left, right, 480);
+
+        auto expected = makeSines(numSamples);
+        const auto saturation = SharedTables::getSaturation();
+        const auto inputGain = std::pow(10.0f, drive * 5.0f * 0.05f);
+        const auto outputGain = 0.63661977236f * 1.5f * std::pow(10.0f, -drive * 5.0f * 0.04f);
+
+        for (auto& sample : expected)
+            sample = saturation->atan(inputGain * sample) * outputGain;
+
+        LadderKernel kernel;
+        kernel.setMode(LadderKernel::Mode::LPF24);
+        kernel.prepare(sampleRate, 1);
+        kernel.setDrive(1.0f);
+        kernel.setCutoffFrequencyHz(cutoff);
+        kernel.setResonance(resonance);
+        kernel.reset();
+
+        float* channel = expected.data();
+        kernel.process(&channel, 1, numSamples);
+
+        for (auto& sample : expected)
+            sample *= std::pow(10.0f, trim * 0.05f);
+
+        EXPECT_BELOW(TestHelpers::maxDifference(left, expected), 1e-5);
+        EXPECT(left == right);
+    }
+
+    //a drive change ramps over 50 ms and then holds
+    void testRamp()
+    {
+        std::vector<float> left (9600, 0.1f), right (9600, 0.1f);
+        LadderEngine engine;
+        engine.setParameter(Parameter::cutoff, 20000.0f);
+        engine.prepare(sampleRate, 2);
+        processInBlocks(engine, left, right, 256);
+
+        std::fill(left.begin(), left.end(), 0.1f);
+        std::fill(right.begin(), right.end(), 0.1f);
+        engine.setParameter(Parameter::drive, 6.0f);
+        processInBlocks(engine, left, right, 256);
+
+        double largestStep = 0.0;
+
+        for (size_t i = 1; i < left.size(); i++)
+            largestStep = std::max(largestStep, (double) std::abs(left[i] - left[i - 1]));
+
+        EXPECT_BELOW(largestStep, 1e-3);
+        EXPECT_BELOW(std::abs(left[9599] - left[4800]), 1e-6);
+    }
+}
+
+int main()
+{
+    testParameters();
+    testUnpreparedAndSilence();
+    testMatchesChain();
+    testRamp();
+    return TestHelpers::finish("EngineTests");
+}
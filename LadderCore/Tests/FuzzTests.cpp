@@ -0,0 +1,400 @@
+/*
+  ==============================================================================
+
+    FuzzTests.cpp
+
+    LadderEngine called the way hosts call processBlock, at random: block
+    sizes from 0 to far past anything a host announces, prepare() again at
+    odd sample rates and channel counts with a different instruction set,
+    whole parameter sets restored at once, and values at and beyond their
+    limits, including infinities and NaN, in the audio as well as in the
+    parameters.
+
+    After every block the output has to be finite, samples past the end of
+    the block and channels past the prepared count have to be untouched,
+    and the block has to have finished within its time budget. LadderLanes
+    gets the same checks with settings inside the plugin's ranges, and the
+    C API is handed bad arguments along the way. The plugin's processBlock
+    isn't LadderEngine, PluginFuzzTests in LadderFilter/Tests fuzzes it.
+
+        FuzzTests [--seed n] [--steps n] [--budget fraction]
+
+    --budget is the share of a block's real-time length it may take, on
+    top of a fixed 2 ms for the scheduler; 0 turns the timing check off,
+    as sanitizer builds should. Configure with -DLADDER_SANITIZE=address,
+    undefined to have out-of-bounds reads and writes caught as well; the
+    nightly job runs both. A failure prints the seed and step to rerun.
+
+  ==============================================================================
+*/
+
+#include "LadderCore.h"
+#include "LadderEngine.h"
+#include "LadderLanes.h"
+#include "TestHelpers.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace
+{
+    using Parameter = LadderEngine::Parameter;
+
+    //written past the end of every block and into channels that mustn't be processed
+    constexpr float guardValue = 12345.0f;
+    constexpr int guardSize = 16;
+    constexpr int maxChannels = 8;
+
+    struct Options
+    {
+        unsigned int seed = 1;
+        long steps = 2000;
+        double budget = 0.5;
+    };
+
+    class Fuzzer
+    {
+    public:
+        explicit Fuzzer(const Options& o) : options(o), random(o.seed) {}
+
+        ~Fuzzer()
+        {
+            ladder_destroy(cEngine);
+        }
+
+        //false as soon as a check fails
+        bool run()
+        {
+            cEngine = ladder_create();
+            ladder_prepare(cEngine, 48000.0, 2);
+
+            for (step = 0; step < options.steps; step++) {
+                const auto event = pick(0, 99);
+
+                if (event < 55) processEngine();
+                else if (event < 70) setParameter();
+                else if (event < 75) restoreState();
+                else if (event < 79) prepare();
+                else if (event < 81) engine.reset();
+                else if (event < 92) processLanes();
+                else callApi();
+
+                if (failed)
+                    return false;
+                }
+
+            std::printf("%ld steps, %ld blocks (%ld samples), %d prepares, longest block %.3f ms\n",
+                        options.steps, blocks, samples, prepares, longestBlock * 1000.0);
+            return true;
+        }
+
+    private:
+        //----------------------------------------------------------------------
+        //not the standard distributions, so a seed means the same run everywhere
+        int pick(int minimum, int maximum)
+        {
+            return minimum + (int) (random() % (unsigned int) (maximum - minimum + 1));
+        }
+
+        float pickUniform(float minimum, float maximum)
+        {
+            return minimum + (maximum - minimum) * (float) (random() >> 8) * (1.0f / 16777216.0f);
+        }
+
+        //mostly small, sometimes empty, sometimes far bigger than any host's maximum
+        int pickBlockSize()
+        {
+            const auto kind = pick(0, 19);
+
+            if (kind < 3) return 0;
+            if (kind < 7) return pick(1, 16);
+            if (kind < 16) return pick(17, 1024);
+            if (kind < 19) return pick(1025, 8192);
+            return pick(8193, 65536);
+        }
+
+        float pickExtreme()
+        {
+            const float extremes[] = { INFINITY, -INFINITY, NAN, 1.0e30f, -1.0e30f, 1.0e-40f, -1.0e-40f, 0.0f, -0.0f,
+                                       std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(),
+                                       std::numeric_limits<float>::denorm_min() };
+            return extremes[pick(0, (int) (sizeof (extremes) / sizeof (extremes[0])) - 1)];
+        }
+
+        float pickValue(Parameter parameter)
+        {
+            const auto minimum = LadderEngine::getMinimum(parameter), maximum = LadderEngine::getMaximum(parameter);
+            const auto kind = pick(0, 9);
+
+            if (kind < 4) return pickUniform(minimum, maximum);
+            if (kind < 6) return pick(0, 1) == 0 ? minimum : maximum;
+            if (kind < 7) return pick(0, 1) == 0 ? minimum - pickUniform(0.0f, 100.0f) : maximum + pickUniform(0.0f, 100.0f);
+            return pickExtreme();
+        }
+
+        //noise, silence, DC, denormals or huge values, with the odd infinity or NaN mixed in
+        void fillSignal(float* data, int numSamples, bool finiteOnly)
+        {
+            const auto kind = pick(0, 5);
+            const float levels[] = { 1.0e-6f, 0.01f, 0.5f, 1.0f, 4.0f, 1000.0f, 1.0e30f };
+            const auto level = levels[pick(0, 6)];
+
+            for (int i = 0; i < numSamples; i++) {
+                switch (kind) {
+                    case 0: data[i] = 0.0f; break;
+                    case 1: data[i] = level; break;
+                    case 2: data[i] = pickUniform(-1.0f, 1.0f) * 1.0e-38f; break;
+                    default: data[i] = pickUniform(-level, level); break;
+                    }
+                }
+
+            if (! finiteOnly && numSamples > 0 && pick(0, 9) == 0)
+                for (int spikes = pick(1, 4); spikes > 0; spikes--)
+                    data[pick(0, numSamples - 1)] = pickExtreme();
+        }
+
+        //----------------------------------------------------------------------
+        bool check(bool condition, const char* what)
+        {
+            if (! condition && ! failed) {
+                std::printf("FAILED seed %u step %ld: %s (rate %g, %d channels prepared)\n",
+                            options.seed, step, what, sampleRate, numChannels);
+                failed = true;
+                ++TestHelpers::failures();
+                }
+
+            return condition;
+        }
+
+        template <typename Function>
+        static double timeOnce(Function&& function)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count();
+        }
+
+        //Runs process(processor, data) and checks it kept to the budget. A block over budget is
+        //timed again from copies taken before it ran, so one preemption by the scheduler doesn't
+        //fail the run while a slow path shows up both times.
+        template <typename Processor, typename Data, typename Process>
+        void timeBlock(Processor& processor, Data& data, int numSamples, Process&& process)
+        {
+            const auto processorBefore = processor;
+            const auto dataBefore = data;
+            auto elapsed = timeOnce([&] { process(processor, data); });
+
+            const auto budget = options.budget * numSamples / sampleRate + 0.002;
+
+            if (options.budget > 0.0 && elapsed > budget) {
+                auto processorAgain = processorBefore;
+                auto dataAgain = dataBefore;
+                elapsed = std::min(elapsed, timeOnce([&] { process(processorAgain, dataAgain); }));
+
+                check(elapsed <= budget, ("block of " + std::to_string(numSamples) + " samples took "
+                                          + std::to_string(elapsed * 1000.0) + " ms twice").c_str());
+                }
+
+            ++blocks;
+            samples += numSamples;
+            longestBlock = std::max(longestBlock, elapsed);
+        }
+
+        //one buffer per possible channel, each with a guard zone after the block, the unused ones all guard
+        std::vector<std::vector<float>> makeBuffers(int numSamples, int numFilled, bool finiteOnly)
+        {
+            std::vector<std::vector<float>> buffers (maxChannels, std::vector<float> ((size_t) (numSamples + guardSize), guardValue));
+
+            for (int channel = 0; channel < numFilled; channel++)
+                fillSignal(buffers[(size_t) channel].data(), numSamples, finiteOnly);
+
+            return buffers;
+        }
+
+        //Past the end of each processed block, and all of every other channel, has to be as it was,
+        //compared bit for bit so NaN counts as unchanged
+        void checkUnchanged(const std::vector<std::vector<float>>& buffers, const std::vector<std::vector<float>>& input,
+                            int numSamples, int numProcessed)
+        {
+            for (size_t channel = 0; channel < buffers.size(); channel++) {
+                const auto from = (int) channel < numProcessed ? (size_t) numSamples : 0;
+                const auto bytes = (buffers[channel].size() - from) * sizeof (float);
+
+                if (! check(std::memcmp(buffers[channel].data() + from, input[channel].data() + from, bytes) == 0,
+                            (int) channel < numProcessed ? "wrote past the end of the block" : "changed a channel it shouldn't process"))
+                    return;
+                }
+        }
+
+        void checkFinite(const std::vector<std::vector<float>>& buffers, int numSamples, int numProcessed)
+        {
+            for (int channel = 0; channel < numProcessed; channel++)
+                for (int i = 0; i < numSamples; i++)
+                    if (! check(std::isfinite(buffers[(size_t) channel][(size_t) i]), "non-finite output"))
+                        return;
+        }
+
+        //----------------------------------------------------------------------
+        void processEngine()
+        {
+            const auto numSamples = pickBlockSize();
+            const auto requested = pick(0, maxChannels);
+            auto buffers = makeBuffers(numSamples, requested, false);
+            const auto input = buffers;
+
+            timeBlock(engine, buffers, numSamples, [&] (LadderEngine& processor, std::vector<std::vector<float>>& data) {
+                float* channels[maxChannels];
+
+                for (size_t channel = 0; channel < data.size(); channel++)
+                    channels[channel] = data[channel].data();
+
+                processor.process(channels, requested, numSamples);
+            });
+
+            //an unprepared engine leaves everything alone
+            const auto processed = engine.isPrepared() ? std::min(requested, numChannels) : 0;
+            checkFinite(buffers, numSamples, processed);
+            checkUnchanged(buffers, input, numSamples, processed);
+        }
+
+        void setParameter()
+        {
+            const auto parameter = (Parameter) pick(0, LadderEngine::numParameters - 1);
+            engine.setParameter(parameter, pickValue(parameter));
+
+            const auto value = engine.getParameter(parameter);
+            check(value >= LadderEngine::getMinimum(parameter) && value <= LadderEngine::getMaximum(parameter),
+                  "a parameter left its range");
+        }
+
+        //what setStateInformation does: every value at once, from the same block
+        void restoreState()
+        {
+            for (int i = 0; i < LadderEngine::numParameters; i++)
+                engine.setParameter((Parameter) i, pickValue((Parameter) i));
+
+            if (pick(0, 1) == 0)
+                engine.reset();
+        }
+
+        void prepare()
+        {
+            const double rates[] = { 8000.0, 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 192000.0, 384000.0 };
+            sampleRate = pick(0, 4) == 0 ? (double) pick(1000, 768000) : rates[pick(0, 7)];
+            numChannels = pick(1, maxChannels);
+
+            const auto instructionSet = CpuDispatch::allInstructionSets[pick(0, 4)];
+
+            if (! CpuDispatch::force(instructionSet))
+                CpuDispatch::clearForced();
+
+            engine.prepare(sampleRate, numChannels);
+            lanes.prepare(sampleRate);
+            ++prepares;
+        }
+
+        void processLanes()
+        {
+            using Lanes = LadderLanes<8>;
+
+            //the plugin's ranges only, the rack clamps before it gets here
+            for (int lane = 0; lane < Lanes::lanes; lane++) {
+                if (pick(0, 3) == 0) {
+                    Lanes::Settings settings;
+                    settings.drive = pickUniform(0.0f, 10.0f);
+                    settings.cutoff = pick(0, 4) == 0 ? 20000.0f : pickUniform(20.0f, 20000.0f);
+                    settings.resonance = pick(0, 4) == 0 ? 1.0f : pickUniform(0.0f, 1.0f);
+                    settings.trimDecibels = pickUniform(-36.0f, 36.0f);
+                    settings.mode = (LadderKernel::Mode) pick(0, 5);
+                    lanes.setLane(lane, settings);
+                    }
+                }
+
+            const auto numSamples = pickBlockSize();
+            std::vector<float> frames ((size_t) (numSamples * Lanes::lanes + guardSize), guardValue);
+            fillSignal(frames.data(), numSamples * Lanes::lanes, true);
+
+            timeBlock(lanes, frames, numSamples, [&] (Lanes& processor, std::vector<float>& data) { processor.process(data.data(), numSamples); });
+
+            for (int i = 0; i < numSamples * Lanes::lanes; i++)
+                if (! check(std::isfinite(frames[(size_t) i]), "non-finite lanes output"))
+                    return;
+
+            for (auto i = (size_t) (numSamples * Lanes::lanes); i < frames.size(); i++)
+                if (! check(frames[i] == guardValue, "lanes wrote outside the block"))
+                    return;
+        }
+
+        //bad arguments are refused, and the engine still works afterwards
+        void callApi()
+        {
+            float sample = 0.5f;
+            float* channel = &sample;
+            float* nullChannel = nullptr;
+            float value = 0.0f;
+
+            const double badRates[] = { 0.0, -48000.0, INFINITY, -INFINITY, NAN };
+            check(ladder_prepare(cEngine, badRates[pick(0, 4)], 2) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_prepare took a bad rate");
+            check(ladder_prepare(cEngine, 48000.0, -pick(0, 10)) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_prepare took a bad channel count");
+            check(ladder_set_param(cEngine, (ladder_param) pick(5, 1000), 1.0f) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_set_param took a bad parameter");
+            check(ladder_get_param(cEngine, LADDER_PARAM_DRIVE, nullptr) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_get_param took a null value");
+            check(ladder_process(cEngine, &channel, 1, -pick(1, 1000)) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_process took a negative length");
+            check(ladder_process(cEngine, nullptr, 1, 1) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_process took null channels");
+            check(ladder_process(cEngine, &nullChannel, 1, 1) == LADDER_ERROR_INVALID_ARGUMENT, "ladder_process took a null channel");
+
+            const auto param = (ladder_param) pick(0, LadderEngine::numParameters - 1);
+            check(ladder_set_param(cEngine, param, pickExtreme()) == LADDER_OK && ladder_get_param(cEngine, param, &value) == LADDER_OK,
+                  "ladder_set_param refused a value");
+
+            check(ladder_process(cEngine, &channel, 1, 1) == LADDER_OK, "ladder_process refused a good block");
+            check(std::isfinite(sample), "non-finite C API output");
+        }
+
+        //----------------------------------------------------------------------
+        Options options;
+        std::mt19937 random;
+        long step = 0;
+        bool failed = false;
+
+        LadderEngine engine;
+        LadderLanes<8> lanes;
+        ladder_engine* cEngine = nullptr;
+        double sampleRate = 48000.0;
+        int numChannels = 0;
+
+        long blocks = 0, samples = 0;
+        int prepares = 0;
+        double longestBlock = 0.0;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--seed") == 0) options.seed = (unsigned int) std::strtoul(argv[i + 1], nullptr, 10);
+            else if (std::strcmp(argv[i], "--steps") == 0) options.steps = std::strtol(argv[i + 1], nullptr, 10);
+            else if (std::strcmp(argv[i], "--budget") == 0) options.budget = std::strtod(argv[i + 1], nullptr);
+            else return false;
+            }
+
+        return argc % 2 == 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (! parseOptions(argc, argv, options)) {
+        std::printf("usage: FuzzTests [--seed n] [--steps n] [--budget fraction]\n");
+        return 1;
+        }
+
+    std::printf("seed %u\n", options.seed);
+    Fuzzer (options).run();
+    CpuDispatch::clearForced();
+    return TestHelpers::finish("FuzzTests");
+}
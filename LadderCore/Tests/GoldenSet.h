@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    GoldenSet.h
+
+    What every golden comparison shares: the test signal and its parts, the
+    parameter grid, the tolerance of the single chain, and the sample and
+    third-octave band measures against the files in Tests/Golden. Used by
+    GoldenTests and by the plugin's own golden harness in LadderFilter/Tests,
+    which holds processBlock to the same files.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ReferenceChain.h"
+#include "Spectrum.h"
+#include "TestHelpers.h"
+#include "WavFile.h"
+#include <random>
+#include <string>
+
+namespace GoldenSet
+{
+    using Mode = LadderKernel::Mode;
+    using Settings = ReferenceChain::Settings;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr double pi = 3.14159265358979323846;
+    constexpr int numModes = 6;
+    const char* const modeNames[numModes] = { "LPF12", "HPF12", "BPF12", "LPF24", "HPF24", "BPF24" };
+
+    //the test signal's parts, each a power of two long for the spectra
+    struct Segment
+    {
+        const char* name;
+        int start, length;
+    };
+
+    constexpr Segment segments[] = {
+        { "impulse", 0, 1024 },
+        { "sweep", 1024, 4096 },
+        { "noise", 5120, 2048 },
+        { "sine -24 dB", 7168, 1024 },
+        { "sine -12 dB", 8192, 1024 },
+        { "sine -6 dB", 9216, 1024 },
+        { "sine 0 dB", 10240, 1024 },
+        { "sine +6 dB", 11264, 1024 }
+    };
+
+    constexpr int numSamples = 12288;
+
+    //settings at the start, and what they're moved to at changeAt
+    struct GridPoint
+    {
+        const char* name;
+        Settings initial, changed;
+        int changeAt;
+    };
+
+    const GridPoint grid[] = {
+        { "gentle", { 0.0f, 750.0f, 0.5f, 0.0f }, { 0.0f, 5000.0f, 0.5f, 0.0f }, 5120 },
+        { "driven", { 4.0f, 2500.0f, 0.9f, -6.0f }, { 6.0f, 600.0f, 0.9f, -6.0f }, 5120 },
+        { "hot", { 10.0f, 150.0f, 0.2f, 6.0f }, { 10.0f, 150.0f, 1.0f, 0.0f }, 7168 }
+    };
+
+    constexpr int numGridPoints = (int) (sizeof (grid) / sizeof (grid[0]));
+
+    struct Tolerance
+    {
+        double maxDifference, bandDecibels;
+    };
+
+    //How far a fast path may be from the references, by mode, a few times what's measured now.
+    //The engine only differs by its tables, the high-pass modes amplify that the most.
+    constexpr Tolerance engineTolerances[numModes] = {
+        { 1e-5, 0.005 }, { 1e-5, 0.02 }, { 1e-5, 0.02 }, { 1e-5, 0.01 }, { 2e-5, 0.05 }, { 1e-5, 0.02 }
+    };
+
+    //the same samples on every platform: std::mt19937's output is specified, the distributions aren't
+    inline std::vector<float> makeSignal()
+    {
+        std::vector<float> signal ((size_t) numSamples, 0.0f);
+        signal[0] = 1.0f;
+
+        //exponential sweep, 20 Hz to 20 kHz at -6 dB
+        const auto& sweep = segments[1];
+        const auto ratio = std::log(20000.0 / 20.0), duration = sweep.length / sampleRate;
+
+        for (int i = 0; i < sweep.length; i++) {
+            const auto t = i / sampleRate;
+            const auto phase = 2.0 * pi * 20.0 * duration / ratio * (std::exp(t / duration * ratio) - 1.0);
+            signal[(size_t) (sweep.start + i)] = 0.5f * (float) std::sin(phase);
+            }
+
+        const auto& noise = segments[2];
+        std::mt19937 random (46);
+
+        for (int i = 0; i < noise.length; i++)
+            signal[(size_t) (noise.start + i)] = (float) (random() >> 8) * (1.0f / 16777216.0f) - 0.5f;
+
+        //a whole number of cycles in each part, 234.375 Hz
+        const float levels[] = { -24.0f, -12.0f, -6.0f, 0.0f, 6.0f };
+
+        for (int level = 0; level < 5; level++) {
+            const auto& part = segments[3 + level];
+            const auto amplitude = std::pow(10.0f, levels[level] * 0.05f);
+
+            for (int i = 0; i < part.length; i++)
+                signal[(size_t) (part.start + i)] = amplitude * (float) std::sin(2.0 * pi * 5.0 * i / part.length);
+            }
+
+        return signal;
+    }
+
+    //calls process(start, count) in blocks of at most blockSize, with a block boundary at changeAt
+    template <typename Process, typename Change>
+    void renderInBlocks(int blockSize, int changeAt, Process&& process, Change&& change)
+    {
+        for (int start = 0; start < numSamples;) {
+            if (start == changeAt)
+                change();
+
+            auto count = std::min(blockSize, numSamples - start);
+
+            if (start < changeAt && start + count > changeAt)
+                count = changeAt - start;
+
+            process(start, count);
+            start += count;
+            }
+    }
+
+    //--------------------------------------------------------------------------
+    //energy of a Hann-windowed part in third-octave bands from 20 Hz up, scaled so a full-scale sine reads 1
+    inline std::vector<double> getBandEnergies(const std::vector<float>& signal, const Segment& segment)
+    {
+        std::vector<std::complex<double>> spectrum ((size_t) segment.length);
+
+        for (int i = 0; i < segment.length; i++) {
+            const auto window = 0.5 - 0.5 * std::cos(2.0 * pi * i / segment.length);
+            spectrum[(size_t) i] = window * signal[(size_t) (segment.start + i)];
+            }
+
+        Spectrum::fft(spectrum);
+
+        std::vector<double> energies;
+        const auto scale = 32.0 / (3.0 * segment.length * segment.length);
+        const auto binWidth = sampleRate / segment.length;
+        auto bin = 1;
+
+        for (auto lower = 20.0; lower < sampleRate / 2.0; lower *= std::pow(2.0, 1.0 / 3.0)) {
+            const auto upper = lower * std::pow(2.0, 1.0 / 3.0);
+            auto energy = 0.0;
+            auto count = 0;
+
+            for (; bin <= segment.length / 2 && bin * binWidth < upper; bin++, count++)
+                energy += std::norm(spectrum[(size_t) bin]);
+
+            //bands narrower than a bin are folded into the next one
+            if (count > 0)
+                energies.push_back(energy * scale);
+            }
+
+        return energies;
+    }
+
+    //The largest band level difference in dB over every part. Bands more than 60 dB below the
+    //part's total or below -100 dBFS are left out, there the float rounding of a correct render
+    //is already a sizeable share of the level.
+    inline double getBandDifference(const std::vector<float>& signal, const std::vector<float>& reference)
+    {
+        auto largest = 0.0;
+
+        for (const auto& segment : segments) {
+            const auto measured = getBandEnergies(signal, segment);
+            const auto expected = getBandEnergies(reference, segment);
+
+            auto total = 0.0;
+
+            for (auto energy : expected)
+                total += energy;
+
+            const auto floor = std::max(total * 1.0e-6, 1.0e-10);
+
+            for (size_t band = 0; band < expected.size(); band++)
+                if (expected[band] > floor)
+                    largest = std::max(largest, std::abs(10.0 * std::log10((measured[band] + 1.0e-30) / expected[band])));
+            }
+
+        return largest;
+    }
+
+    //--------------------------------------------------------------------------
+    inline std::string getPath(const std::string& directory, int mode)
+    {
+        return directory + "/" + modeNames[mode] + ".wav";
+    }
+
+    inline bool load(const std::string& directory, std::vector<WavFile>& references)
+    {
+        references.resize(numModes);
+
+        for (int mode = 0; mode < numModes; mode++) {
+            std::string error;
+
+            if (! references[(size_t) mode].read(getPath(directory, mode), error)) {
+                std::printf("FAILED %s\n", error.c_str());
+                return false;
+                }
+
+            const auto& file = references[(size_t) mode];
+            EXPECT(file.sampleRate == sampleRate && file.getNumChannels() == numGridPoints && file.getNumSamples() == numSamples);
+            }
+
+        return TestHelpers::failures() == 0;
+    }
+
+    //the worst over the grid, for one mode
+    struct Differences
+    {
+        double samples = 0.0, bands = 0.0;
+
+        void add(const std::vector<float>& output, const std::vector<float>& reference)
+        {
+            samples = std::max(samples, TestHelpers::maxDifference(output, reference));
+            bands = std::max(bands, getBandDifference(output, reference));
+        }
+    };
+
+    inline void check(const char* path, int mode, const Tolerance& tolerance, const Differences& differences)
+    {
+        std::printf("%s %s: ", path, modeNames[mode]);
+        EXPECT_BELOW(differences.samples, tolerance.maxDifference);
+        std::printf("%s %s: ", path, modeNames[mode]);
+        EXPECT_BELOW(differences.bands, tolerance.bandDecibels);
+    }
+}
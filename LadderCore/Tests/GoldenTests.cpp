@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    GoldenTests.cpp
+
+    Stored renders of the plugin's sound, and every fast path held to them.
+
+    Tests/Golden has one float WAV per filter mode, one channel per point of
+    a small parameter grid, each with a parameter change part way through.
+    They were rendered by ReferenceChain (softClip + juce::dsp::LadderFilter
+    with exact atan and tanh) from a fixed signal: an impulse, a sweep,
+    noise, and a sine at five levels.
+
+    The engine is rendered with every instruction set this machine has, at
+    an even and an odd block size, and LadderLanes with one lane per mode.
+    Each is compared per mode on the largest sample difference and on the
+    largest difference in third-octave band energy within any part of the
+    signal. ReferenceChain is also checked against the files, so a change
+    to it can't quietly move the target. The plugin's processBlock runs its
+    own chain rather than LadderEngine, PluginGoldenTests in
+    LadderFilter/Tests holds it to the same files.
+
+        GoldenTests <golden directory>             compare (what ctest runs)
+        GoldenTests --update <golden directory>    render the files again
+
+    Only update the files when the sound is meant to change, and then in
+    ReferenceChain first.
+
+  ==============================================================================
+*/
+
+#include "GoldenSet.h"
+#include "LadderEngine.h"
+#include "LadderLanes.h"
+#include <cstring>
+
+namespace
+{
+    using namespace GoldenSet;
+
+    //LadderLanes ramps like the single chain, so what's left is its rational curves. tanh is within
+    //1e-4 and atan within 2e-6, which moves a render by around 1e-4; again a few times what's measured.
+    constexpr Tolerance lanesTolerances[numModes] = {
+        { 4e-4, 0.1 }, { 2e-4, 0.15 }, { 3e-4, 0.1 }, { 3e-4, 0.05 }, { 1e-4, 0.05 }, { 2e-4, 0.2 }
+    };
+
+    //ReferenceChain against the files, which only a different libm should move
+    constexpr double referenceTolerance = 1e-5;
+
+    std::vector<float> renderReference(Mode mode, const GridPoint& point)
+    {
+        std::vector<std::vector<float>> channels { makeSignal() };
+        ReferenceChain chain (mode, 1, sampleRate, point.initial);
+
+        renderInBlocks(numSamples, point.changeAt,
+                       [&] (int start, int count) { chain.process(channels, (size_t) start, (size_t) (start + count)); },
+                       [&] { chain.set(point.changed); });
+
+        return channels[0];
+    }
+
+    void setEngine(LadderEngine& engine, const Settings& settings)
+    {
+        engine.setParameter(LadderEngine::Parameter::drive, settings.drive);
+        engine.setParameter(LadderEngine::Parameter::cutoff, settings.cutoff);
+        engine.setParameter(LadderEngine::Parameter::resonance, settings.resonance);
+        engine.setParameter(LadderEngine::Parameter::trim, settings.trimDecibels);
+    }
+
+    std::vector<float> renderEngine(Mode mode, const GridPoint& point, int blockSize)
+    {
+        auto signal = makeSignal();
+
+        LadderEngine engine;
+        engine.setParameter(LadderEngine::Parameter::mode, (float) mode);
+        setEngine(engine, point.initial);
+        engine.prepare(sampleRate, 1);
+
+        renderInBlocks(blockSize, point.changeAt,
+                       [&] (int start, int count) { float* channel = signal.data() + start; engine.process(&channel, 1, count); },
+                       [&] { setEngine(engine, point.changed); });
+
+        return signal;
+    }
+
+    //one lane per mode, the two spare lanes run LPF12 as well
+    std::vector<std::vector<float>> renderLanes(const GridPoint& point)
+    {
+        using Lanes = LadderLanes<8>;
+        const auto signal = makeSignal();
+
+        auto setLanes = [] (Lanes& lanes, const Settings& settings) {
+            for (int lane = 0; lane < Lanes::lanes; lane++)
+                lanes.setLane(lane, { settings.drive, settings.cutoff, settings.resonance, settings.trimDecibels, (Mode) (lane % numModes) });
+        };
+
+        Lanes lanes;
+        lanes.prepare(sampleRate);
+        setLanes(lanes, point.initial);
+        lanes.reset();
+
+        std::vector<float> frames ((size_t) numSamples * Lanes::lanes);
+
+        for (size_t i = 0; i < signal.size(); i++)
+            std::fill_n(frames.begin() + (std::ptrdiff_t) (i * Lanes::lanes), Lanes::lanes, signal[i]);
+
+        renderInBlocks(512, point.changeAt,
+                       [&] (int start, int count) { lanes.process(frames.data() + (size_t) start * Lanes::lanes, count); },
+                       [&] { setLanes(lanes, point.changed); });
+
+        std::vector<std::vector<float>> outputs (numModes, std::vector<float> ((size_t) numSamples));
+
+        for (size_t mode = 0; mode < outputs.size(); mode++)
+            for (size_t i = 0; i < (size_t) numSamples; i++)
+                outputs[mode][i] = frames[i * Lanes::lanes + mode];
+
+        return outputs;
+    }
+
+    int update(const std::string& directory)
+    {
+        for (int mode = 0; mode < numModes; mode++) {
+            WavFile file;
+            file.sampleRate = sampleRate;
+
+            for (const auto& point : grid)
+                file.channels.push_back(renderReference((Mode) mode, point));
+
+            std::string error;
+
+            if (! file.write(getPath(directory, mode), error)) {
+                std::printf("%s\n", error.c_str());
+                return 1;
+                }
+
+            std::printf("wrote %s\n", getPath(directory, mode).c_str());
+            }
+
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && std::strcmp(argv[1], "--update") == 0)
+        return update(argv[2]);
+
+    if (argc != 2) {
+        std::printf("usage: GoldenTests [--update] <golden directory>\n");
+        return 1;
+        }
+
+    std::vector<WavFile> references;
+
+    if (! load(argv[1], references))
+        return TestHelpers::finish("GoldenTests");
+
+    for (int mode = 0; mode < numModes; mode++) {
+        double difference = 0.0;
+
+        for (int point = 0; point < numGridPoints; point++)
+            difference = std::max(difference, TestHelpers::maxDifference(renderReference((Mode) mode, grid[point]),
+                                                                          references[(size_t) mode].channels[(size_t) point]));
+
+        std::printf("reference %s: ", modeNames[mode]);
+        EXPECT_BELOW(difference, referenceTolerance);
+        }
+
+    for (auto instructionSet : CpuDispatch::allInstructionSets) {
+        if (! CpuDispatch::force(instructionSet))
+            continue;
+
+        for (auto blockSize : { 512, 61 }) {
+            char path[64];
+            std::snprintf(path, sizeof (path), "%s/%d", CpuDispatch::getName(instructionSet), blockSize);
+
+            for (int mode = 0; mode < numModes; mode++) {
+                Differences differences;
+
+                for (int point = 0; point < numGridPoints; point++)
+                    differences.add(renderEngine((Mode) mode, grid[point], blockSize), references[(size_t) mode].channels[(size_t) point]);
+
+                check(path, mode, engineTolerances[mode], differences);
+                }
+            }
+        }
+
+    CpuDispatch::clearForced();
+
+    Differences lanes[numModes];
+
+    for (int point = 0; point < numGridPoints; point++) {
+        const auto outputs = renderLanes(grid[point]);
+
+        for (int mode = 0; mode < numModes; mode++)
+            lanes[mode].add(outputs[(size_t) mode], references[(size_t) mode].channels[(size_t) point]);
+        }
+
+    for (int mode = 0; mode < numModes; mode++)
+        check("lanes", mode, lanesTolerances[mode], lanes[mode]);
+
+    return TestHelpers::finish("GoldenTests");
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    KernelTests.cpp
+
+    LadderKernel against a straight port of juce::dsp::LadderFilter's
+    processSample (exact std::tanh, linear 50 ms ramps) in every mode,
+    with a cutoff jump part way through. The kernel's table tanh is the
+    only intended difference.
+
+  ==============================================================================
+*/
+
+#include "ReferenceChain.h"
+#include "TestHelpers.h"
+#include <random>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+
+    std::vector<std::vector<float>> makeNoise(int numChannels, int numSamples)
+    {
+        std::mt19937 random (1);
+        std::uniform_real_distribution<float> noise (-0.8f, 0.8f);
+        std::vector<std::vector<float>> channels ((size_t) numChannels, std::vector<float> ((size_t) numSamples));
+
+        for (auto& channel : channels)
+            for (auto& sample : channel)
+                sample = noise(random);
+
+        return channels;
+    }
+
+    double compareWithReference(LadderKernel::Mode mode)
+    {
+        const int numSamples = 24000, blockSize = 512, jumpAt = 6144;
+        auto processed = makeNoise(2, numSamples);
+        auto expected = processed;
+
+        LadderKernel kernel;
+        kernel.setMode(mode);
+        kernel.prepare(sampleRate, 2);
+        kernel.setDrive(1.0f);
+        kernel.setCutoffFrequencyHz(750.0f);
+        kernel.setResonance(0.5f);
+
+        ReferenceLadder reference (mode, 2, sampleRate);
+        reference.setCutoff(750.0f);
+        reference.setResonance(0.5f);
+
+        for (int offset = 0; offset < numSamples; offset += blockSize) {
+            if (offset == jumpAt) {
+                kernel.setCutoffFrequencyHz(3000.0f);
+                reference.setCutoff(3000.0f);
+                }
+
+            const auto count = std::min(blockSize, numSamples - offset);
+            float* channels[] = { processed[0].data() + offset, processed[1].data() + offset };
+            kernel.process(channels, 2, count);
+            reference.process(expected, (size_t) offset, (size_t) (offset + count));
+            }
+
+        double difference = 0.0;
+
+        for (size_t channel = 0; channel < 2; channel++)
+            difference = std::max(difference, TestHelpers::maxDifference(processed[channel], expected[channel]));
+
+        return difference;
+    }
+}
+
+int main()
+{
+    const char* names[] = { "LPF12", "HPF12", "BPF12", "LPF24", "HPF24", "BPF24" };
+
+    for (int mode = 0; mode < 6; mode++) {
+        std::printf("%s: ", names[mode]);
+        EXPECT_BELOW(compareWithReference((LadderKernel::Mode) mode), 1e-5);
+        }
+
+    //modulating by zero octaves is the plain path
+    {
+        auto plain = makeNoise(1, 4096);
+        auto modulated = plain;
+        const std::vector<float> offsets (4096, 0.0f);
+
+        LadderKernel a, b;
+
+        for (auto* kernel : { &a, &b }) {
+            kernel->prepare(sampleRate, 1);
+            kernel->setDrive(1.0f);
+            kernel->setCutoffFrequencyHz(1000.0f);
+            kernel->setResonance(0.7f);
+            kernel->reset();
+            }
+
+        float* p = plain[0].data();
+        float* m = modulated[0].data();
+        a.process(&p, 1, 4096);
+        b.processModulated(&m, 1, 4096, offsets.data());
+
+        EXPECT_BELOW(TestHelpers::maxDifference(plain[0], modulated[0]), 1e-3);
+    }
+
+    //a mode change fades rather than steps
+    {
+        std::vector<float> signal (9600, 0.25f);
+        LadderKernel kernel;
+        kernel.prepare(sampleRate, 1);
+        kernel.setDrive(1.0f);
+        kernel.reset();
+
+        float* p = signal.data();
+        kernel.process(&p, 1, 4800);
+        kernel.setMode(LadderKernel::Mode::HPF24);
+        p += 4800;
+        kernel.process(&p, 1, 4800);
+
+        double largestStep = 0.0;
+
+        for (size_t i = 4800; i < signal.size(); i++)
+            largestStep = std::max(largestStep, (double) std::abs(signal[i] - signal[i - 1]));
+
+        EXPECT_BELOW(largestStep, 0.05);
+    }
+
+    return TestHelpers::finish("KernelTests");
+}
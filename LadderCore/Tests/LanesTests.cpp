@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    LanesTests.cpp
+
+    LaneMath's rational tanh and atan against the standard library, and
+    LadderLanes against the single chain with the same settings. Lanes
+    with different settings must not leak into each other.
+
+  ==============================================================================
+*/
+
+#include "LadderLanes.h"
+#include "TestHelpers.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+
+    template <typename Approximation, typename Exact>
+    double curveError(Approximation&& approximation, Exact&& exact, float range)
+    {
+        double error = 0.0;
+
+        for (float x = -range; x <= range; x += 0.001f) {
+            float result[Float4::size];
+            store(result, approximation(broadcast(x)));
+            error = std::max(error, (double) std::abs(result[0] - exact(x)));
+            }
+
+        return error;
+    }
+
+    std::vector<float> makeSines(int numSamples)
+    {
+        std::vector<float> signal ((size_t) numSamples);
+
+        for (size_t i = 0; i < signal.size(); i++)
+            signal[i] = 0.5f * (float) std::sin(2.0 * 3.14159265358979 * 220.0 * (double) i / sampleRate)
+                      + 0.3f * (float) std::sin(2.0 * 3.14159265358979 * 3100.0 * (double) i / sampleRate);
+
+        return signal;
+    }
+
+    //table saturation, kernel and trim, as the plugin runs one chain
+    std::vector<float> processChain(const LadderLanes<8>::Settings& settings, int numSamples)
+    {
+        auto signal = makeSines(numSamples);
+        const auto saturation = SharedTables::getSaturation();
+        const auto drive = settings.drive * 5.0f;
+        const auto inputGain = std::pow(10.0f, drive * 0.05f);
+        const auto outputGain = 0.63661977236f * 1.5f * std::pow(10.0f, -drive * 0.04f);
+
+        for (auto& sample : signal)
+            sample = saturation->atan(inputGain * sample) * outputGain;
+
+        LadderKernel kernel;
+        kernel.setMode(settings.mode);
+        kernel.prepare(sampleRate, 1);
+        kernel.setDrive(1.0f);
+        kernel.setCutoffFrequencyHz(settings.cutoff);
+        kernel.setResonance(settings.resonance);
+        kernel.reset();
+
+        float* channel = signal.data();
+        kernel.process(&channel, 1, numSamples);
+
+        for (auto& sample : signal)
+            sample *= std::pow(10.0f, settings.trimDecibels * 0.05f);
+
+        return signal;
+    }
+}
+
+int main()
+{
+    EXPECT_BELOW(curveError([] (Float4 x) { return LaneMath::tanh(x); }, [] (float x) { return std::tanh(x); }, 8.0f), 1e-4);
+    EXPECT_BELOW(curveError([] (Float4 x) { return LaneMath::atan(x); }, [] (float x) { return std::atan(x); }, 100.0f), 3e-6);
+
+    const int numSamples = 24000;
+    const auto input = makeSines(numSamples);
+
+    LadderLanes<8> lanes;
+    lanes.prepare(sampleRate);
+
+    std::vector<LadderLanes<8>::Settings> settings (8);
+
+    for (int lane = 0; lane < 8; lane++) {
+        settings[(size_t) lane].drive = 0.5f * (float) lane;
+        settings[(size_t) lane].cutoff = 300.0f * (float) (lane + 1);
+        settings[(size_t) lane].resonance = 0.1f * (float) lane;
+        settings[(size_t) lane].trimDecibels = -(float) lane;
+        settings[(size_t) lane].mode = (LadderKernel::Mode) (lane % 6);
+        lanes.setLane(lane, settings[(size_t) lane]);
+        }
+
+    lanes.reset();
+
+    std::vector<float> frames ((size_t) numSamples * 8);
+
+    for (size_t i = 0; i < input.size(); i++)
+        std::fill_n(frames.begin() + (std::ptrdiff_t) (i * 8), 8, input[i]);
+
+    for (int offset = 0; offset < numSamples; offset += 500)
+        lanes.process(frames.data() + offset * 8, std::min(500, numSamples - offset));
+
+    for (int lane = 0; lane < 8; lane++) {
+        const auto expected = processChain(settings[(size_t) lane], numSamples);
+        std::vector<float> actual ((size_t) numSamples);
+
+        for (size_t i = 0; i < actual.size(); i++)
+            actual[i] = frames[i * 8 + (size_t) lane];
+
+        std::printf("lane %d: ", lane);
+        EXPECT_BELOW(TestHelpers::maxDifference(actual, expected), 2e-5);
+        }
+
+    return TestHelpers::finish("LanesTests");
+}
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    PrepareCacheTests.cpp
+
+    PrepareCache's ordering and eviction, that a cached configuration keeps
+    its cutoff table alive, and that a released LadderKernel leaves audio
+    alone and comes back from prepare() as good as new.
+
+  ==============================================================================
+*/
+
+#include "LadderKernel.h"
+#include "PrepareCache.h"
+#include "TestHelpers.h"
+
+namespace
+{
+    //rates nothing else in the process has asked for, so only the cache holds their tables
+    constexpr double rateA = 47000.0, rateB = 45000.0, rateC = 43000.0;
+
+    void testOrderAndEviction()
+    {
+        PrepareCache cache (2);
+        EXPECT(! cache.prepare({ rateA, 512, 2 }));
+        EXPECT(cache.prepare({ rateA, 512, 2 }));
+        EXPECT(cache.size() == 1);
+
+        //any field makes a different configuration
+        EXPECT(! cache.prepare({ rateA, 256, 2 }));
+        EXPECT(! cache.contains({ rateA, 512, 1 }));
+        EXPECT(cache.size() == 2);
+
+        //using the older one makes the other the one to go
+        EXPECT(cache.prepare({ rateA, 512, 2 }));
+        EXPECT(! cache.prepare({ rateB, 512, 2 }));
+        EXPECT(cache.contains({ rateA, 512, 2 }) && cache.contains({ rateB, 512, 2 }));
+        EXPECT(! cache.contains({ rateA, 256, 2 }));
+
+        cache.clear();
+        EXPECT(cache.size() == 0 && ! cache.contains({ rateA, 512, 2 }));
+    }
+
+    void testTablesKept()
+    {
+        PrepareCache cache (1);
+        cache.prepare({ rateC, 512, 2 });
+
+        std::weak_ptr<const CutoffTable> table = SharedTables::getCutoff(rateC);
+        EXPECT(! table.expired());
+        EXPECT(SharedTables::getCutoff(rateC) == table.lock());
+
+        //a kernel going back and forth between rates finds its table where it left it
+        LadderKernel kernel;
+        kernel.prepare(rateC, 2);
+        kernel.prepare(rateA, 2);
+        EXPECT(! table.expired());
+
+        cache.prepare({ rateB, 512, 2 });
+        EXPECT(table.expired());
+    }
+
+    std::vector<float> render(LadderKernel& kernel)
+    {
+        std::vector<float> left (2048), right (2048), octaves (2048, 0.5f);
+
+        for (size_t i = 0; i < left.size(); i++)
+            left[i] = right[i] = (float) std::sin(0.05 * (double) i);
+
+        float* channels[] = { left.data(), right.data() };
+        kernel.process(channels, 2, 1024);
+
+        float* rest[] = { left.data() + 1024, right.data() + 1024 };
+        kernel.processModulated(rest, 2, 512, octaves.data());
+
+        float* last[] = { left.data() + 1536, right.data() + 1536 };
+        kernel.processRamped(last, 2, 512, -0.5f, 0.1f);
+        return left;
+    }
+
+    void testRelease()
+    {
+        LadderKernel fresh, released;
+
+        for (auto* kernel : { &fresh, &released }) {
+            kernel->setMode(LadderKernel::Mode::BPF24);
+            kernel->setCutoffFrequencyHz(900.0f);
+            kernel->setResonance(0.7f);
+            kernel->prepare(rateA, 2);
+            }
+
+        render(released);
+        released.release();
+
+        //nothing to filter with, the audio goes through as it came
+        std::vector<float> input (512, 0.25f), octaves (512, 1.0f);
+        float* channels[] = { input.data(), input.data() };
+        released.process(channels, 2, 512);
+        released.processModulated(channels, 1, 512, octaves.data());
+        released.processRamped(channels, 1, 512, 1.0f, 0.0f);
+        EXPECT(std::all_of(input.begin(), input.end(), [] (float sample) { return sample == 0.25f; }));
+
+        released.prepare(rateA, 2);
+        EXPECT(TestHelpers::maxDifference(render(fresh), render(released)) == 0.0);
+    }
+}
+
+int main()
+{
+    testOrderAndEviction();
+    testTablesKept();
+    testRelease();
+    return TestHelpers::finish("PrepareCacheTests");
+}
@@ -0,0 +1,141 @@
+# ==============================================================================
+#
+#   PythonModuleTests.py
+#
+#   The ladder_core module as a script would use it: audio filtered in
+#   place, float32 and float64 giving the same result, per-sample
+#   automation and its shape checks, and two filters processing at once
+#   on two threads. Uses the standard array module, so NumPy isn't needed.
+#   Run by ctest with the built module on PYTHONPATH.
+#
+# ==============================================================================
+
+import array
+import math
+import sys
+import threading
+
+import ladder_core
+
+failures = 0
+
+
+def expect(condition, what):
+    global failures
+    if not condition:
+        print("FAILED " + what)
+        failures += 1
+
+
+def expect_raises(error, what, call):
+    try:
+        call()
+    except error:
+        return
+    except Exception as other:
+        expect(False, "%s raised %s instead of %s" % (what, type(other).__name__, error.__name__))
+        return
+    expect(False, "%s didn't raise %s" % (what, error.__name__))
+
+
+def make_input(typecode, channels, samples):
+    # rounded through float32 so both types start from exactly the same values
+    values = array.array("f", (0.5 * math.sin(0.01 * (i % samples) * (1 + i // samples)) for i in range(channels * samples)))
+    return array.array(typecode, values)
+
+
+def as_channels(data, channels):
+    return memoryview(data).cast("B").cast(data.typecode, [channels, len(data) // channels])
+
+
+def make_filter(channels=2):
+    ladder = ladder_core.Filter(48000.0, channels)
+    ladder.drive = 4.0
+    ladder.cutoff = 900.0
+    ladder.resonance = 0.7
+    return ladder
+
+
+def max_difference(a, b):
+    return max(abs(x - y) for x, y in zip(a, b))
+
+
+samples = 4096
+
+# in place: the caller's buffer holds the output, nothing is returned
+data = make_input("f", 2, samples)
+original = array.array("f", data)
+expect(make_filter().process(as_channels(data, 2)) is None, "process returns None")
+expect(max_difference(data, original) > 0.01, "stereo audio is filtered in place")
+
+mono = make_input("f", 1, samples)
+original = array.array("f", mono)
+make_filter(1).process(mono)
+expect(max_difference(mono, original) > 0.01, "mono audio is filtered in place")
+
+# float64 is run through float32, so the two agree to float32 rounding of the output
+single = make_input("f", 2, samples)
+double = make_input("d", 2, samples)
+make_filter().process(as_channels(single, 2))
+make_filter().process(as_channels(double, 2))
+expect(max_difference(single, double) < 1.0e-6, "float32 and float64 agree")
+
+# automation holding the current values changes nothing, moving automation does
+static = make_input("f", 2, samples)
+make_filter().process(as_channels(static, 2))
+
+held = make_input("f", 2, samples)
+make_filter().process(as_channels(held, 2), cutoff=array.array("f", [900.0] * samples), drive=array.array("d", [4.0] * samples))
+expect(max_difference(static, held) < 1.0e-6, "held automation matches fixed parameters")
+
+swept = make_input("f", 2, samples)
+make_filter().process(as_channels(swept, 2), cutoff=array.array("f", (200.0 + 4.0 * i for i in range(samples))))
+expect(max_difference(static, swept) > 0.01, "cutoff automation moves the cutoff")
+
+# automation that could be read past its end, or isn't floats, is refused before any audio changes
+audio = make_input("f", 2, samples)
+untouched = array.array("f", audio)
+ladder = make_filter()
+expect_raises(ValueError, "short automation", lambda: ladder.process(as_channels(audio, 2), cutoff=array.array("f", [900.0] * (samples - 1))))
+expect_raises(ValueError, "long automation", lambda: ladder.process(as_channels(audio, 2), trim=array.array("f", [0.0] * (samples + 1))))
+expect_raises(ValueError, "2-d automation", lambda: ladder.process(as_channels(audio, 2), drive=as_channels(make_input("f", 2, samples), 2)))
+expect_raises(TypeError, "integer automation", lambda: ladder.process(as_channels(audio, 2), resonance=array.array("i", [0] * samples)))
+expect_raises(TypeError, "integer audio", lambda: ladder.process(array.array("i", [0] * samples)))
+expect_raises(ValueError, "too many channels", lambda: ladder.process(as_channels(make_input("f", 3, samples), 3)))
+expect(audio == untouched, "refused calls leave the audio alone")
+
+# two filters on two threads at once give what each gives alone
+long_samples = 1 << 18
+expected = []
+
+for cutoff in (500.0, 5000.0):
+    data = make_input("f", 2, long_samples)
+    ladder = make_filter()
+    ladder.cutoff = cutoff
+    ladder.process(as_channels(data, 2))
+    expected.append(data)
+
+results = [make_input("f", 2, long_samples) for _ in expected]
+filters = [make_filter() for _ in expected]
+filters[0].cutoff, filters[1].cutoff = 500.0, 5000.0
+start = threading.Barrier(len(filters))
+
+
+def work(index):
+    start.wait()
+    filters[index].process(as_channels(results[index], 2))
+
+
+threads = [threading.Thread(target=work, args=(index,)) for index in range(len(filters))]
+
+for thread in threads:
+    thread.start()
+
+for thread in threads:
+    thread.join()
+
+for index in range(len(filters)):
+    expect(results[index] == expected[index], "filter %d on its own thread matches the single-threaded run" % index)
+
+print("PythonModuleTests: " + ("passed" if failures == 0 else "FAILED"))
+sys.exit(0 if failures == 0 else 1)
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    TestHelpers.h
+
+    The few checks the test executables share. Each test file is its own
+    program; failures are printed as they happen and main() returns
+    finish(), which is non-zero if anything failed.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace TestHelpers
+{
+    inline int& failures() noexcept
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void expect(bool condition, const char* what, const char* file, int line)
+    {
+        if (! condition) {
+            std::printf("FAILED %s:%d: %s\n", file, line, what);
+            ++failures();
+            }
+    }
+
+    //prints the measured value either way so the logs show the margin
+    inline void expectBelow(double value, double limit, const char* what, const char* file, int line)
+    {
+        const bool passed = value < limit;
+        std::printf("%s %s = %g (limit %g)\n", passed ? "ok    " : "FAILED", what, value, limit);
+
+        if (! passed) {
+            std::printf("       at %s:%d\n", file, line);
+            ++failures();
+            }
+    }
+
+    inline double maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        if (a.size() != b.size())
+            return INFINITY;
+
+        double difference = 0.0;
+
+        for (size_t i = 0; i < a.size(); i++)
+            difference = std::max(difference, (double) std::abs(a[i] - b[i]));
+
+        return difference;
+    }
+
+    inline int finish(const char* name)
+    {
+        std::printf("%s: %s\n", name, failures() == 0 ? "passed" : "FAILED");
+        return failures() == 0 ? 0 : 1;
+    }
+}
+
+#define EXPECT(condition) TestHelpers::expect ((condition), #condition, __FILE__, __LINE__)
+#define EXPECT_BELOW(value, limit) TestHelpers::expectBelow ((value), (limit), #value, __FILE__, __LINE__)
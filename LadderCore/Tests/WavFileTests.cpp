@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    WavFileTests.cpp
+
+    WavFile writes float files that read back bit for bit, reads PCM, and
+    rejects files it doesn't understand.
+
+  ==============================================================================
+*/
+
+#include "WavFile.h"
+#include "TestHelpers.h"
+
+namespace
+{
+    void writeBytes(const std::string& path, const std::vector<unsigned char>& bytes)
+    {
+        std::ofstream stream (path, std::ios::binary);
+        stream.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize) bytes.size());
+    }
+}
+
+int main()
+{
+    std::string error;
+
+    //float round trip
+    {
+        WavFile file;
+        file.sampleRate = 44100.0;
+        file.channels = { { 0.0f, 0.5f, -1.0f, 1.0e-20f }, { 1.0f, -0.25f, 3.0f, -0.0f } };
+        EXPECT(file.write("wav_round_trip.wav", error));
+
+        WavFile read;
+        EXPECT(read.read("wav_round_trip.wav", error));
+        EXPECT(read.sampleRate == 44100.0);
+        EXPECT(read.channels == file.channels);
+    }
+
+    //mono 16-bit PCM with an odd-sized chunk ahead of the data
+    {
+        const std::vector<unsigned char> bytes = {
+            'R', 'I', 'F', 'F', 48, 0, 0, 0, 'W', 'A', 'V', 'E',
+            'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1, 0, 0x80, 0xbb, 0, 0, 0, 0x77, 1, 0, 2, 0, 16, 0,
+            'j', 'u', 'n', 'k', 1, 0, 0, 0, 0, 0,
+            'd', 'a', 't', 'a', 4, 0, 0, 0, 0x00, 0x40, 0x00, 0x80
+        };
+
+        writeBytes("wav_pcm16.wav", bytes);
+
+        WavFile read;
+        EXPECT(read.read("wav_pcm16.wav", error));
+        EXPECT(read.sampleRate == 48000.0 && read.getNumChannels() == 1 && read.getNumSamples() == 2);
+        EXPECT(read.getNumSamples() == 2 && read.channels[0][0] == 0.5f && read.channels[0][1] == -1.0f);
+    }
+
+    //8-bit and non-WAV files are refused with a message
+    {
+        writeBytes("wav_not_wav.wav", { 'n', 'o', 'p', 'e' });
+
+        WavFile read;
+        error.clear();
+        EXPECT(! read.read("wav_not_wav.wav", error) && ! error.empty());
+        EXPECT(! read.read("wav_does_not_exist.wav", error));
+    }
+
+    return TestHelpers::finish("WavFileTests");
+}
@@ -0,0 +1,352 @@
+/*
+  ==============================================================================
+
+    LadderQuality.cpp
+
+    Quality against cost, for every way this tree can run the chain and
+    every filter mode, as one table:
+
+        reference       ReferenceChain, exact std::atan and std::tanh
+        engine <set>    LadderEngine with each instruction set CpuDispatch
+                        can use here (table atan and tanh)
+        lanes           LadderLanes<8> as the rack runs it (rational curves)
+
+    There is no oversampling in the chain, so these paths are its quality
+    tiers. The columns:
+
+        THD+N       a 999.8 Hz sine at -6 dBFS with the drive at 1:
+                    everything but the fundamental, against it
+        aliasing    a 5000.2 Hz sine, same settings: the lines off the
+                    harmonic series (harmonics folded back from above
+                    Nyquist) louder than -140 dB, summed, against the
+                    fundamental
+        response    the largest difference from the reference's small-signal
+                    frequency response between 20 Hz and 20 kHz, where the
+                    reference is within 60 dB of its peak
+        ns/sample   per channel sample, same settings, 512-sample blocks
+
+    Cutoffs sit where the tones pass: 8 kHz for the low-passes, 250 Hz for
+    the high-passes, 1 kHz for the band-passes, resonance 0.5. A * marks
+    rows no other path in the same mode beats on aliasing, response and
+    cost all at once, counting differences smaller than the table shows
+    and costs within 10% of each other as ties.
+
+        ladder_quality [--csv]
+
+  ==============================================================================
+*/
+
+#include "LadderEngine.h"
+#include "LadderLanes.h"
+#include "ReferenceChain.h"
+#include "Spectrum.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+
+namespace
+{
+    using Mode = LadderKernel::Mode;
+    using Settings = ReferenceChain::Settings;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr double pi = 3.14159265358979323846;
+    constexpr int numModes = 6;
+    const char* const modeNames[numModes] = { "LPF12", "HPF12", "BPF12", "LPF24", "HPF24", "BPF24" };
+
+    //measured after the ramps and the filter have settled, whole cycles only so every line sits on a bin
+    constexpr int fftSize = 65536;
+    constexpr int settleSamples = 16384;
+    constexpr int lowToneBin = 1365, highToneBin = 6827;
+    constexpr float toneLevel = 0.5012f;
+    constexpr double aliasingFloor = 1.0e-14;
+
+    //+5 dB into the clipper: audibly driven without the clipper swamping every column
+    constexpr float measuredDrive = 1.0f;
+
+    constexpr int blockSize = 512;
+    constexpr int costSamples = 48000;
+
+    Settings getSettings(Mode mode, float drive)
+    {
+        const float cutoffs[] = { 8000.0f, 250.0f, 1000.0f };
+        return { drive, cutoffs[(int) mode % 3], 0.5f, 0.0f };
+    }
+
+    //--------------------------------------------------------------------------
+    //one way of running the chain: renders a mono signal in place from a fresh start and
+    //returns the seconds spent processing, channelsAtOnce is how many it could have done in that time
+    struct Path
+    {
+        std::string name;
+        int channelsAtOnce;
+        std::function<double (Mode, const Settings&, std::vector<float>&)> render;
+    };
+
+    template <typename Process>
+    double processInBlocks(int numSamples, Process&& process)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int offset = 0; offset < numSamples; offset += blockSize)
+            process(offset, std::min(blockSize, numSamples - offset));
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    Path makeReference()
+    {
+        return { "reference", 1, [] (Mode mode, const Settings& settings, std::vector<float>& signal) {
+            std::vector<std::vector<float>> channels { std::move(signal) };
+            ReferenceChain chain (mode, 1, sampleRate, settings);
+
+            const auto seconds = processInBlocks((int) channels[0].size(), [&] (int start, int count) {
+                chain.process(channels, (size_t) start, (size_t) (start + count));
+            });
+
+            signal = std::move(channels[0]);
+            return seconds;
+        } };
+    }
+
+    Path makeEngine(InstructionSet instructionSet)
+    {
+        return { std::string ("engine ") + CpuDispatch::getName(instructionSet), 1,
+                 [instructionSet] (Mode mode, const Settings& settings, std::vector<float>& signal) {
+            CpuDispatch::force(instructionSet);
+
+            LadderEngine engine;
+            engine.setParameter(LadderEngine::Parameter::mode, (float) mode);
+            engine.setParameter(LadderEngine::Parameter::drive, settings.drive);
+            engine.setParameter(LadderEngine::Parameter::cutoff, settings.cutoff);
+            engine.setParameter(LadderEngine::Parameter::resonance, settings.resonance);
+            engine.setParameter(LadderEngine::Parameter::trim, settings.trimDecibels);
+            engine.prepare(sampleRate, 1);
+            CpuDispatch::clearForced();
+
+            return processInBlocks((int) signal.size(), [&] (int start, int count) {
+                float* channel = signal.data() + start;
+                engine.process(&channel, 1, count);
+            });
+        } };
+    }
+
+    //every lane runs the same settings, lane 0 is the output
+    Path makeLanes()
+    {
+        using Lanes = LadderLanes<8>;
+
+        return { "lanes", Lanes::lanes, [] (Mode mode, const Settings& settings, std::vector<float>& signal) {
+            Lanes lanes;
+            lanes.prepare(sampleRate);
+
+            for (int lane = 0; lane < Lanes::lanes; lane++)
+                lanes.setLane(lane, { settings.drive, settings.cutoff, settings.resonance, settings.trimDecibels, mode });
+
+            lanes.reset();
+
+            std::vector<float> frames (signal.size() * Lanes::lanes);
+
+            for (size_t i = 0; i < signal.size(); i++)
+                std::fill_n(frames.begin() + (std::ptrdiff_t) (i * Lanes::lanes), Lanes::lanes, signal[i]);
+
+            const auto seconds = processInBlocks((int) signal.size(), [&] (int start, int count) {
+                lanes.process(frames.data() + (size_t) start * Lanes::lanes, count);
+            });
+
+            for (size_t i = 0; i < signal.size(); i++)
+                signal[i] = frames[i * Lanes::lanes];
+
+            return seconds;
+        } };
+    }
+
+    //--------------------------------------------------------------------------
+    std::vector<float> makeTone(int bin)
+    {
+        std::vector<float> signal ((size_t) (settleSamples + fftSize));
+
+        for (size_t i = 0; i < signal.size(); i++)
+            signal[i] = toneLevel * (float) std::sin(2.0 * pi * bin * (double) i / fftSize);
+
+        return signal;
+    }
+
+    std::vector<double> measureTone(const Path& path, Mode mode, int bin)
+    {
+        auto signal = makeTone(bin);
+        path.render(mode, getSettings(mode, measuredDrive), signal);
+        return Spectrum::getPower(signal.data() + settleSamples, fftSize);
+    }
+
+    double toDecibels(double power) { return 10.0 * std::log10(power); }
+
+    double measureThdPlusNoise(const Path& path, Mode mode)
+    {
+        const auto power = measureTone(path, mode, lowToneBin);
+        auto rest = 0.0;
+
+        for (size_t bin = 1; bin < power.size(); bin++)
+            if (bin != (size_t) lowToneBin)
+                rest += power[bin];
+
+        return toDecibels(rest / power[(size_t) lowToneBin]);
+    }
+
+    //-inf when nothing clears the floor
+    double measureAliasing(const Path& path, Mode mode)
+    {
+        const auto power = measureTone(path, mode, highToneBin);
+        const auto fundamental = power[(size_t) highToneBin];
+        std::vector<bool> harmonic (power.size(), false);
+
+        for (size_t bin = highToneBin; bin < power.size(); bin += highToneBin)
+            harmonic[bin] = true;
+
+        auto aliased = 0.0;
+
+        for (size_t bin = 1; bin < power.size(); bin++)
+            if (! harmonic[bin] && power[bin] > fundamental * aliasingFloor)
+                aliased += power[bin];
+
+        return toDecibels(aliased / fundamental);
+    }
+
+    //the power spectrum of a quiet impulse with the drive off
+    std::vector<double> measureResponse(const Path& path, Mode mode)
+    {
+        std::vector<float> signal ((size_t) fftSize, 0.0f);
+        signal[0] = 1.0e-3f;
+        path.render(mode, getSettings(mode, 0.0f), signal);
+        return Spectrum::getPower(signal.data(), fftSize);
+    }
+
+    double getResponseDifference(const std::vector<double>& response, const std::vector<double>& reference)
+    {
+        const auto lowest = (size_t) std::ceil(20.0 * fftSize / sampleRate);
+        const auto highest = (size_t) (20000.0 * fftSize / sampleRate);
+        const auto peak = *std::max_element(reference.begin() + (std::ptrdiff_t) lowest, reference.begin() + (std::ptrdiff_t) highest + 1);
+        auto largest = 0.0;
+
+        for (auto bin = lowest; bin <= highest; bin++)
+            if (reference[bin] > peak * 1.0e-6)
+                largest = std::max(largest, std::abs(toDecibels(response[bin] / reference[bin])));
+
+        return largest;
+    }
+
+    //the best of a few runs, per channel sample
+    double measureCost(const Path& path, Mode mode)
+    {
+        std::mt19937 random (48);
+        std::vector<float> noise ((size_t) costSamples);
+
+        for (auto& sample : noise)
+            sample = (float) (random() >> 8) * (1.0f / 16777216.0f) - 0.5f;
+
+        auto best = INFINITY;
+
+        for (int run = 0; run < 3; run++) {
+            auto signal = noise;
+            best = std::min(best, (float) path.render(mode, getSettings(mode, measuredDrive), signal));
+            }
+
+        return best * 1.0e9 / ((double) costSamples * path.channelsAtOnce);
+    }
+
+    //--------------------------------------------------------------------------
+    struct Row
+    {
+        const char* mode;
+        std::string path;
+        double thdPlusNoise, aliasing, response, cost;
+        bool pareto = true;
+
+        //compared at the precision the table shows, timings within 10% are noise
+        bool isBeatenBy(const Row& other) const noexcept
+        {
+            const auto aliasingDifference = std::round(aliasing * 10.0) - std::round(other.aliasing * 10.0);
+            const auto responseDifference = std::round(response * 1000.0) - std::round(other.response * 1000.0);
+            const auto cheaper = other.cost < cost * 0.9, dearer = other.cost > cost * 1.1;
+
+            const auto noWorse = ! (aliasingDifference < 0) && responseDifference >= 0 && ! dearer;
+            const auto better = aliasingDifference > 0 || responseDifference > 0 || cheaper;
+            return noWorse && better;
+        }
+    };
+
+    void markPareto(std::vector<Row>& rows)
+    {
+        for (auto& row : rows)
+            for (const auto& other : rows)
+                if (row.mode == other.mode && row.isBeatenBy(other))
+                    row.pareto = false;
+    }
+
+    void printTable(const std::vector<Row>& rows)
+    {
+        std::printf("%-6s %-14s %9s %11s %11s %10s\n", "mode", "path", "THD+N dB", "aliasing dB", "response dB", "ns/sample");
+
+        for (const auto& row : rows) {
+            char aliasing[32];
+
+            if (std::isinf(row.aliasing))
+                std::snprintf(aliasing, sizeof (aliasing), "< %.0f", toDecibels(aliasingFloor));
+            else
+                std::snprintf(aliasing, sizeof (aliasing), "%.1f", row.aliasing);
+
+            std::printf("%-6s %-14s %9.1f %11s %11.3f %10.2f %s\n", row.mode, row.path.c_str(), row.thdPlusNoise,
+                        aliasing, row.response, row.cost, row.pareto ? "*" : "");
+            }
+    }
+
+    void printCsv(const std::vector<Row>& rows)
+    {
+        std::printf("mode,path,thd_n_db,aliasing_db,response_db,ns_per_sample,pareto\n");
+
+        for (const auto& row : rows)
+            std::printf("%s,%s,%.2f,%.2f,%.4f,%.3f,%d\n", row.mode, row.path.c_str(), row.thdPlusNoise,
+                        std::isinf(row.aliasing) ? toDecibels(aliasingFloor) : row.aliasing, row.response, row.cost, row.pareto ? 1 : 0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const auto csv = argc == 2 && std::strcmp(argv[1], "--csv") == 0;
+
+    if (argc > 2 || (argc == 2 && ! csv)) {
+        std::puts("usage: ladder_quality [--csv]");
+        return 1;
+        }
+
+    std::vector<Path> paths { makeReference() };
+
+    for (auto instructionSet : CpuDispatch::allInstructionSets)
+        if (CpuDispatch::isAvailable(instructionSet))
+            paths.push_back(makeEngine(instructionSet));
+
+    paths.push_back(makeLanes());
+
+    std::vector<Row> rows;
+
+    for (int mode = 0; mode < numModes; mode++) {
+        const auto reference = measureResponse(paths[0], (Mode) mode);
+
+        for (const auto& path : paths)
+            rows.push_back({ modeNames[mode], path.name, measureThdPlusNoise(path, (Mode) mode), measureAliasing(path, (Mode) mode),
+                             getResponseDifference(measureResponse(path, (Mode) mode), reference), measureCost(path, (Mode) mode) });
+        }
+
+    markPareto(rows);
+
+    if (csv)
+        printCsv(rows);
+    else
+        printTable(rows);
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    LadderRender.cpp
+
+    Offline renderer: runs a WAV file through LadderEngine and writes the
+    result as 32-bit float. Needs no audio device or display.
+
+        ladder_render [options] input.wav output.wav
+        ladder_render --generate seconds output.wav
+
+    Options take the plugin's units: --drive 0-10, --cutoff 20-20000,
+    --resonance 0-1, --trim -36-36, --mode 0-5, plus --block for the
+    processing block size. --generate writes stereo white noise at -6 dBFS
+    (--rate sets its sample rate) to have something to render.
+
+  ==============================================================================
+*/
+
+#include "LadderEngine.h"
+#include "WavFile.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace
+{
+    int fail(const std::string& message)
+    {
+        std::fprintf(stderr, "ladder_render: %s\n", message.c_str());
+        return 1;
+    }
+
+    void printUsage()
+    {
+        std::puts("usage: ladder_render [--drive x] [--cutoff hz] [--resonance x] [--trim db] [--mode 0-5] [--block n] input.wav output.wav\n"
+                  "       ladder_render --generate seconds [--rate hz] output.wav");
+    }
+
+    int generate(double seconds, double sampleRate, const std::string& path)
+    {
+        WavFile file;
+        file.sampleRate = sampleRate;
+        file.channels.assign(2, std::vector<float> ((size_t) (seconds * sampleRate)));
+
+        std::mt19937 random (1);
+        std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+
+        for (auto& channel : file.channels)
+            for (auto& sample : channel)
+                sample = noise(random);
+
+        std::string error;
+        return file.write(path, error) ? 0 : fail(error);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    struct Option { const char* name; LadderEngine::Parameter parameter; };
+    const Option options[] = {
+        { "--drive", LadderEngine::Parameter::drive },
+        { "--cutoff", LadderEngine::Parameter::cutoff },
+        { "--resonance", LadderEngine::Parameter::resonance },
+        { "--trim", LadderEngine::Parameter::trim },
+        { "--mode", LadderEngine::Parameter::mode }
+    };
+
+    LadderEngine engine;
+    std::vector<std::string> paths;
+    int blockSize = 512;
+    double generateSeconds = 0.0, generateRate = 48000.0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--help" || argument == "-h") {
+            printUsage();
+            return 0;
+            }
+
+        if (argument.size() > 2 && argument.compare(0, 2, "--") == 0) {
+            if (i + 1 >= argc)
+                return fail(argument + " needs a value");
+
+            const auto value = std::atof(argv[++i]);
+            bool known = false;
+
+            for (const auto& option : options) {
+                if (argument == option.name) {
+                    engine.setParameter(option.parameter, (float) value);
+                    known = true;
+                    }
+                }
+
+            if (argument == "--block")
+                blockSize = (int) value, known = true;
+            else if (argument == "--generate")
+                generateSeconds = value, known = true;
+            else if (argument == "--rate")
+                generateRate = value, known = true;
+
+            if (! known)
+                return fail("unknown option " + argument);
+
+            continue;
+            }
+
+        paths.push_back(argument);
+        }
+
+    if (generateSeconds > 0.0) {
+        if (paths.size() != 1 || ! (generateRate > 0.0))
+            return fail("--generate needs a positive length and one output file");
+
+        return generate(generateSeconds, generateRate, paths[0]);
+        }
+
+    if (paths.size() != 2 || blockSize <= 0) {
+        printUsage();
+        return 1;
+        }
+
+    WavFile file;
+    std::string error;
+
+    if (! file.read(paths[0], error))
+        return fail(error);
+
+    //parameters set above are where the render starts, not ramped to
+    engine.prepare(file.sampleRate, file.getNumChannels());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<float*> channels ((size_t) file.getNumChannels());
+
+    for (int offset = 0; offset < file.getNumSamples(); offset += blockSize) {
+        for (size_t channel = 0; channel < channels.size(); channel++)
+            channels[channel] = file.channels[channel].data() + offset;
+
+        engine.process(channels.data(), file.getNumChannels(), std::min(blockSize, file.getNumSamples() - offset));
+        }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (! file.write(paths[1], error))
+        return fail(error);
+
+    const auto audioSeconds = file.getNumSamples() / file.sampleRate;
+    std::printf("%s: %d channels, %.2f s of audio in %.3f s (%.0fx real time)\n", paths[1].c_str(),
+                file.getNumChannels(), audioSeconds, elapsed.count(), audioSeconds / std::max(elapsed.count(), 1e-9));
+    return 0;
+}
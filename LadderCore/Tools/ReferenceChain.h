@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    ReferenceChain.h
+
+    The plugin's sound written out the slow, obvious way, for the tests to
+    measure the engine against: softClip with std::atan, a straight port of
+    juce::dsp::LadderFilter's processSample with std::tanh, and the trim,
+    each smoothed like juce::SmoothedValue over 50 ms.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "LadderKernel.h"
+#include <vector>
+
+//juce::dsp::LadderFilter, linear ramps on the pole and resonance, drive fixed at 1 as the plugin uses it
+struct ReferenceLadder
+{
+    //juce::SmoothedValue, linear or multiplicative
+    struct Ramp
+    {
+        float current, target, step = 0.0f;
+        int countdown = 0;
+        bool multiplicative = false;
+
+        void setTarget(float newTarget, int steps)
+        {
+            if (newTarget == target)
+                return;
+
+            target = newTarget;
+            countdown = steps;
+            step = multiplicative ? std::exp((std::log(target) - std::log(current)) / (float) countdown)
+                                  : (target - current) / (float) countdown;
+        }
+
+        float next()
+        {
+            if (countdown <= 0)
+                return target;
+
+            --countdown;
+            current = countdown > 0 ? (multiplicative ? current * step : current + step) : target;
+            return current;
+        }
+    };
+
+    ReferenceLadder(LadderKernel::Mode mode, int numChannels, double rate)
+        : sampleRate(rate), steps((int) std::floor(0.05 * rate)), mix(LadderKernel::getTapMix(mode)), state((size_t) numChannels)
+    {
+        cutoff.current = cutoff.target = poleFor(200.0f);
+        resonance.current = resonance.target = 0.1f;
+    }
+
+    float poleFor(float hz) const { return std::exp(hz * float (-2.0 * 3.14159265358979323846 / sampleRate)); }
+
+    void setCutoff(float hz) { cutoff.setTarget(poleFor(hz), steps); }
+    void setResonance(float amount) { resonance.setTarget(0.1f + 0.9f * amount, steps); }
+
+    //settles both ramps on their targets
+    void snap()
+    {
+        cutoff.current = cutoff.target;
+        resonance.current = resonance.target;
+        cutoff.countdown = resonance.countdown = 0;
+    }
+
+    void process(std::vector<std::vector<float>>& channels, size_t start, size_t end)
+    {
+        const float drive = 1.0f, drive2 = drive * 0.04f + 0.96f;
+        const float gain = std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+        const float gain2 = std::pow(drive2, -2.642f) * 0.6103f + 0.3903f;
+
+        for (size_t i = start; i < end; i++) {
+            const auto a1 = cutoff.next();
+            const auto k = resonance.next();
+            const auto g = 1.0f - a1, b0 = g * 0.76923076923f, b1 = g * 0.23076923076f;
+
+            for (size_t channel = 0; channel < channels.size(); channel++) {
+                auto& s = state[channel];
+                const auto dx = gain * std::tanh(drive * channels[channel][i]);
+                const auto a = dx + k * -4.0f * (gain2 * std::tanh(drive2 * s[4]) - dx * mix.compensation);
+                const auto b = b1 * s[0] + a1 * s[1] + b0 * a;
+                const auto c = b1 * s[1] + a1 * s[2] + b0 * b;
+                const auto d = b1 * s[2] + a1 * s[3] + b0 * c;
+                const auto e = b1 * s[3] + a1 * s[4] + b0 * d;
+
+                s = {{ a, b, c, d, e }};
+                channels[channel][i] = a * mix.taps[0] + b * mix.taps[1] + c * mix.taps[2] + d * mix.taps[3] + e * mix.taps[4];
+                }
+            }
+    }
+
+    double sampleRate;
+    int steps;
+    LadderKernel::TapMix mix;
+    std::vector<std::array<float, 5>> state;
+    Ramp cutoff, resonance;
+};
+
+//softClip -> ReferenceLadder -> trim, in the plugin's parameter units
+struct ReferenceChain
+{
+    struct Settings
+    {
+        float drive, cutoff, resonance, trimDecibels;
+    };
+
+    ReferenceChain(LadderKernel::Mode mode, int numChannels, double sampleRate, const Settings& settings)
+        : ladder(mode, numChannels, sampleRate)
+    {
+        inputGain.multiplicative = outputGain.multiplicative = true;
+
+        for (auto* ramp : { &inputGain, &outputGain, &trimGain })
+            ramp->current = ramp->target = 1.0f;
+
+        set(settings);
+        snap();
+    }
+
+    //ramps towards the new values from the next sample on
+    void set(const Settings& settings)
+    {
+        const auto drive = settings.drive * 5.0f;
+        inputGain.setTarget(std::pow(10.0f, drive * 0.05f), ladder.steps);
+        outputGain.setTarget(0.63661977236f * 1.5f * std::pow(10.0f, -drive * 0.04f), ladder.steps);
+        trimGain.setTarget(std::pow(10.0f, settings.trimDecibels * 0.05f), ladder.steps);
+        ladder.setCutoff(settings.cutoff);
+        ladder.setResonance(settings.resonance);
+    }
+
+    void process(std::vector<std::vector<float>>& channels, size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; i++) {
+            const auto in = inputGain.next(), out = outputGain.next();
+
+            for (auto& channel : channels)
+                channel[i] = std::atan(in * channel[i]) * out;
+            }
+
+        ladder.process(channels, start, end);
+
+        for (size_t i = start; i < end; i++) {
+            const auto gain = trimGain.next();
+
+            for (auto& channel : channels)
+                channel[i] *= gain;
+            }
+    }
+
+private:
+    void snap()
+    {
+        for (auto* ramp : { &inputGain, &outputGain, &trimGain }) {
+            ramp->current = ramp->target;
+            ramp->countdown = 0;
+            }
+
+        ladder.snap();
+    }
+
+    ReferenceLadder ladder;
+    ReferenceLadder::Ramp inputGain, outputGain, trimGain;
+};
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    Spectrum.h
+
+    A plain radix-2 FFT in double precision for the measurement tool and
+    the tests. Sizes must be powers of two; nothing here is fast, only
+    easy to check.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace Spectrum
+{
+    //in place, forward, unscaled
+    inline void fft(std::vector<std::complex<double>>& data)
+    {
+        const auto size = data.size();
+
+        for (size_t i = 1, j = 0; i < size; i++) {
+            auto bit = size >> 1;
+
+            for (; (j & bit) != 0; bit >>= 1)
+                j ^= bit;
+
+            j ^= bit;
+
+            if (i < j)
+                std::swap(data[i], data[j]);
+            }
+
+        for (size_t length = 2; length <= size; length <<= 1) {
+            const auto step = std::polar(1.0, -2.0 * 3.14159265358979323846 / (double) length);
+
+            for (size_t start = 0; start < size; start += length) {
+                std::complex<double> twiddle (1.0);
+
+                for (size_t k = 0; k < length / 2; k++) {
+                    const auto even = data[start + k], odd = data[start + k + length / 2] * twiddle;
+                    data[start + k] = even + odd;
+                    data[start + k + length / 2] = even - odd;
+                    twiddle *= step;
+                    }
+                }
+            }
+    }
+
+    //Power in bins 0 to size / 2 with no window, scaled so a full-scale sine on a bin reads 1.
+    //Only sines with a whole number of cycles in the block stay on one bin.
+    inline std::vector<double> getPower(const float* samples, int size)
+    {
+        std::vector<std::complex<double>> spectrum (samples, samples + size);
+        fft(spectrum);
+
+        std::vector<double> power ((size_t) size / 2 + 1);
+        const auto scale = 4.0 / ((double) size * size);
+
+        for (size_t bin = 0; bin < power.size(); bin++)
+            power[bin] = std::norm(spectrum[bin]) * scale;
+
+        return power;
+    }
+}
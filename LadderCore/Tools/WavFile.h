@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    WavFile.h
+
+    Just enough WAV for the offline tools: reads 16, 24 and 32-bit PCM and
+    32 and 64-bit float, including WAVE_FORMAT_EXTENSIBLE. Writes 32-bit float.
+    Audio is held as one vector per channel.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct WavFile
+{
+    double sampleRate = 48000.0;
+    std::vector<std::vector<float>> channels;
+
+    int getNumChannels() const noexcept { return (int) channels.size(); }
+    int getNumSamples() const noexcept { return channels.empty() ? 0 : (int) channels[0].size(); }
+
+    //false with error set if the file can't be read or isn't a format listed above
+    bool read(const std::string& path, std::string& error)
+    {
+        std::ifstream stream (path, std::ios::binary);
+
+        if (! stream) {
+            error = "can't open " + path;
+            return false;
+            }
+
+        std::vector<unsigned char> data ((std::istreambuf_iterator<char> (stream)), std::istreambuf_iterator<char> ());
+
+        if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 || std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+            error = path + " is not a WAV file";
+            return false;
+            }
+
+        int format = 0, numChannels = 0, bitsPerSample = 0;
+        const unsigned char* samples = nullptr;
+        size_t samplesSize = 0;
+
+        //walk the chunks, each is padded to an even size
+        for (size_t position = 12; position + 8 <= data.size();) {
+            const auto* chunk = data.data() + position;
+            const auto size = (size_t) readLittleEndian(chunk + 4, 4);
+            const auto available = std::min(size, data.size() - position - 8);
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+                format = (int) readLittleEndian(chunk + 8, 2);
+                numChannels = (int) readLittleEndian(chunk + 10, 2);
+                sampleRate = (double) readLittleEndian(chunk + 12, 4);
+                bitsPerSample = (int) readLittleEndian(chunk + 22, 2);
+
+                //WAVE_FORMAT_EXTENSIBLE keeps the real format at the start of the subformat GUID
+                if (format == 0xfffe && available >= 26)
+                    format = (int) readLittleEndian(chunk + 32, 2);
+                }
+            else if (std::memcmp(chunk, "data", 4) == 0) {
+                samples = chunk + 8;
+                samplesSize = available;
+                }
+
+            position += 8 + size + (size & 1);
+            }
+
+        const bool isPcm = format == 1 && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+        const bool isFloat = format == 3 && (bitsPerSample == 32 || bitsPerSample == 64);
+
+        if (samples == nullptr || numChannels <= 0 || ! (sampleRate > 0.0) || ! (isPcm || isFloat)) {
+            error = path + " is not 16, 24 or 32-bit PCM or 32 or 64-bit float";
+            return false;
+            }
+
+        const auto bytesPerSample = (size_t) bitsPerSample / 8;
+        const auto numFrames = samplesSize / (bytesPerSample * (size_t) numChannels);
+        channels.assign((size_t) numChannels, std::vector<float> (numFrames));
+
+        for (size_t frame = 0; frame < numFrames; frame++) {
+            for (size_t channel = 0; channel < (size_t) numChannels; channel++) {
+                const auto* sample = samples + (frame * (size_t) numChannels + channel) * bytesPerSample;
+                channels[channel][frame] = isFloat ? readFloat(sample, bytesPerSample) : readPcm(sample, bytesPerSample);
+                }
+            }
+
+        return true;
+    }
+
+    bool write(const std::string& path, std::string& error) const
+    {
+        const auto numChannels = (uint32_t) getNumChannels();
+        const auto numFrames = (uint32_t) getNumSamples();
+        const uint32_t dataSize = numChannels * numFrames * 4;
+
+        std::vector<unsigned char> data;
+        data.reserve(44 + dataSize);
+
+        auto append = [&data] (const char* text) { data.insert(data.end(), text, text + 4); };
+        auto appendNumber = [&data] (uint32_t value, int bytes) {
+            for (int i = 0; i < bytes; i++)
+                data.push_back((unsigned char) (value >> (8 * i)));
+        };
+
+        append("RIFF");
+        appendNumber(36 + dataSize, 4);
+        append("WAVE");
+        append("fmt ");
+        appendNumber(16, 4);
+        appendNumber(3, 2);
+        appendNumber(numChannels, 2);
+        appendNumber((uint32_t) sampleRate, 4);
+        appendNumber((uint32_t) sampleRate * numChannels * 4, 4);
+        appendNumber(numChannels * 4, 2);
+        appendNumber(32, 2);
+        append("data");
+        appendNumber(dataSize, 4);
+
+        for (uint32_t frame = 0; frame < numFrames; frame++) {
+            for (uint32_t channel = 0; channel < numChannels; channel++) {
+                uint32_t bits;
+                std::memcpy(&bits, &channels[channel][frame], 4);
+                appendNumber(bits, 4);
+                }
+            }
+
+        std::ofstream stream (path, std::ios::binary);
+        stream.write(reinterpret_cast<const char*>(data.data()), (std::streamsize) data.size());
+
+        if (! stream) {
+            error = "can't write " + path;
+            return false;
+            }
+
+        return true;
+    }
+
+private:
+
+    static uint64_t readLittleEndian(const unsigned char* bytes, size_t count) noexcept
+    {
+        uint64_t value = 0;
+
+        for (size_t i = 0; i < count; i++)
+            value |= (uint64_t) bytes[i] << (8 * i);
+
+        return value;
+    }
+
+    static float readPcm(const unsigned char* bytes, size_t count) noexcept
+    {
+        //shift to the top of 32 bits so the sign comes along, then scale to -1..1
+        const auto value = (int32_t) (uint32_t) (readLittleEndian(bytes, count) << (32 - 8 * count));
+        return (float) (value / 2147483648.0);
+    }
+
+    static float readFloat(const unsigned char* bytes, size_t count) noexcept
+    {
+        if (count == 4) {
+            const auto bits = (uint32_t) readLittleEndian(bytes, 4);
+            float value;
+            std::memcpy(&value, &bits, 4);
+            return value;
+            }
+
+        const auto bits = readLittleEndian(bytes, 8);
+        double value;
+        std::memcpy(&value, &bits, 8);
+        return (float) value;
+    }
+};
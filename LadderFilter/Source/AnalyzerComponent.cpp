@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    AnalyzerComponent.cpp
+
+  ==============================================================================
+*/
+
+#include "AnalyzerComponent.h"
+
+AnalyzerComponent::AnalyzerComponent(LadderFilterAudioProcessor& p)
+    : audioProcessor(p), analyzer(p.analyzerFifo)
+{
+    levels.resize(SpectrumAnalyzer::numBins, SpectrumAnalyzer::minDecibels);
+    setInterceptsMouseClicks(false, false);
+    startTimerHz(30);
+}
+
+AnalyzerComponent::~AnalyzerComponent()
+{
+    stopTimer();
+}
+
+void AnalyzerComponent::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colour::fromFloatRGBA(0, 0, 0, 0.15f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+    
+    g.setColour(juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+    g.strokePath(spectrumPath, juce::PathStrokeType(1.0f));
+}
+
+void AnalyzerComponent::resized()
+{
+    updatePath();
+}
+
+void AnalyzerComponent::timerCallback()
+{
+    auto* peer = getPeer();
+    
+    if (! isShowing())
+        analyzer.setDecimation(0);
+    else if (peer != nullptr && peer->isFocused())
+        analyzer.setDecimation(1);
+    else
+        analyzer.setDecimation(unfocusedDecimation);
+    
+    analyzer.requestUpdate();
+    
+    if (analyzer.getLevels(levels)) {
+        updatePath();
+        repaint();
+        }
+}
+
+void AnalyzerComponent::updatePath()
+{
+    spectrumPath.clear();
+    
+    const auto sampleRate = audioProcessor.getSampleRate();
+    const auto width = (float) getWidth();
+    const auto height = (float) getHeight();
+    
+    if (sampleRate <= 0.0 || width <= 0.0f)
+        return;
+    
+    const auto binWidth = sampleRate / SpectrumAnalyzer::fftSize;
+    
+    for (int bin = 1; bin < SpectrumAnalyzer::numBins; bin++) {
+        auto frequency = bin * binWidth;
+        
+        if (frequency < 20.0 || frequency > 20000.0)
+            continue;
+        
+        auto x = width * (float) juce::mapFromLog10(frequency, 20.0, 20000.0);
+        auto y = juce::jmap(levels[bin], SpectrumAnalyzer::minDecibels, 0.0f, height, 0.0f);
+        
+        if (spectrumPath.isEmpty())
+            spectrumPath.startNewSubPath(x, y);
+        else
+            spectrumPath.lineTo(x, y);
+        }
+}
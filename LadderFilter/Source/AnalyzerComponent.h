@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    AnalyzerComponent.h
+
+    Draws the output spectrum. It owns the SpectrumAnalyzer for as long as
+    the editor is open and throttles it when the editor is hidden or not
+    focused.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "SpectrumAnalyzer.h"
+
+class AnalyzerComponent : public juce::Component, private juce::Timer
+{
+public:
+    AnalyzerComponent(LadderFilterAudioProcessor& p);
+    ~AnalyzerComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+
+    void timerCallback() override;
+    void updatePath();
+
+    //every 4th hop while the editor window doesn't have focus
+    static constexpr int unfocusedDecimation = 4;
+
+    LadderFilterAudioProcessor& audioProcessor;
+    SpectrumAnalyzer analyzer;
+
+    std::vector<float> levels;
+    juce::Path spectrumPath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyzerComponent)
+};
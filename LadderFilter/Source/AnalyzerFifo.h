@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    AnalyzerFifo.h
+
+    Single-producer/single-consumer sample FIFO between the audio thread and
+    the spectrum analyzer. Storage is allocated once up front; the audio thread
+    only ever copies into it and drops samples rather than waiting when full.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class AnalyzerFifo
+{
+public:
+    AnalyzerFifo() : fifo(capacity), storage(1, capacity)
+    {
+        storage.clear();
+    }
+
+    //Audio thread: downmixes the block to mono and copies it in, at most one block at a time
+    void push(const juce::AudioBuffer<float>& buffer)
+    {
+        if (! active.load(std::memory_order_relaxed) || buffer.getNumChannels() == 0)
+            return;
+
+        const auto numSamples = juce::jmin(buffer.getNumSamples(), fifo.getFreeSpace());
+
+        if (numSamples <= 0)
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        writeMono(buffer, 0, start1, size1);
+        writeMono(buffer, size1, start2, size2);
+
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    //Analyzer thread: returns the number of samples copied into dest
+    int pull(float* dest, int maxSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        auto* source = storage.getReadPointer(0);
+
+        if (size1 > 0)
+            juce::FloatVectorOperations::copy(dest, source + start1, size1);
+
+        if (size2 > 0)
+            juce::FloatVectorOperations::copy(dest + size1, source + start2, size2);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    //Nothing is pushed unless an analyzer is listening
+    void setActive(bool shouldBeActive) { active.store(shouldBeActive); }
+
+    static constexpr int capacity = 32768;
+
+private:
+
+    void writeMono(const juce::AudioBuffer<float>& buffer, int sourceStart, int destStart, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        auto* dest = storage.getWritePointer(0, destStart);
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), 2);
+
+        if (numChannels == 1) {
+            juce::FloatVectorOperations::copy(dest, buffer.getReadPointer(0, sourceStart), numSamples);
+            }
+        else {
+            juce::FloatVectorOperations::copyWithMultiply(dest, buffer.getReadPointer(0, sourceStart), 0.5f, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(dest, buffer.getReadPointer(1, sourceStart), 0.5f, numSamples);
+            }
+    }
+
+    juce::AbstractFifo fifo;
+    juce::AudioBuffer<float> storage;
+    std::atomic<bool> active { false };
+
+    JUCE_DECLARE_NON_COPYABLE (AnalyzerFifo)
+};
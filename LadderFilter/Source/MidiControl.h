@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    MidiControl.h
+
+    Turns incoming MIDI into changes to the block's settings on the audio
+    thread: mapped CCs set drive, cutoff, resonance or trim, and notes set the
+    key-tracking offset for the cutoff. Controllers that moved are stored in
+    their parameters' raw values once per block, so the next blocks keep
+    them, and handed to the message thread, which sets the parameters so the
+    host, the editor and the saved state follow along. Nothing on the audio
+    thread notifies the host or any listener.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//what the single chain plays, which mapped controllers can move mid-block
+struct ChainSettings
+{
+    float drive = 0.0f;
+    float cutoff = 750.0f;
+    float resonance = 0.5f;
+    float trim = 0.0f;
+};
+
+class MidiControl  : private juce::Timer
+{
+public:
+    enum class Target { none = -1, drive, cutoff, resonance, trim };
+
+    //Parameters and their raw values in Target order, used for the CC ranges and the write-back.
+    //Construct on the message thread.
+    MidiControl(std::array<juce::RangedAudioParameter*, 4> targetParameters, std::array<std::atomic<float>*, 4> targetValues)
+        : parameters(targetParameters), rawValues(targetValues)
+    {
+        ccTargets.fill(Target::none);
+
+        //brightness and harmonic content, plus the first two general purpose controllers
+        setMapping(74, Target::cutoff);
+        setMapping(71, Target::resonance);
+        setMapping(16, Target::drive);
+        setMapping(17, Target::trim);
+
+        startTimerHz(30);
+    }
+
+    ~MidiControl() override
+    {
+        stopTimer();
+    }
+
+    //Not thread-safe with handle(), call before playback starts
+    void setMapping(int controllerNumber, Target target)
+    {
+        if (juce::isPositiveAndBelow(controllerNumber, 128))
+            ccTargets[(size_t) controllerNumber] = target;
+    }
+
+    //Audio thread. Applies one message to settings.
+    void handle(const juce::MidiMessage& message, ChainSettings& settings) noexcept
+    {
+        if (message.isController()) {
+            auto target = ccTargets[(size_t) message.getControllerNumber()];
+
+            if (target == Target::none)
+                return;
+
+            auto index = (size_t) target;
+            auto value = parameters[index]->convertFrom0to1(message.getControllerValue() / 127.0f);
+
+            switch (target) {
+                case Target::drive: settings.drive = value; break;
+                case Target::cutoff: settings.cutoff = value; break;
+                case Target::resonance: settings.resonance = value; break;
+                case Target::trim: settings.trim = value; break;
+                case Target::none: break;
+                }
+
+            pendingValues[index] = value;
+            pendingMask |= 1 << index;
+            }
+        else if (message.isNoteOn()) {
+            //the last note played wins, and stays after release so the cutoff doesn't jump
+            keyTrackOctaves = (message.getNoteNumber() - 60) / 12.0f;
+            }
+        else if (message.isAllNotesOff() || message.isResetAllControllers()) {
+            keyTrackOctaves = 0.0f;
+            }
+    }
+
+    //Octaves of cutoff shift from middle C for the last note played
+    float getKeyTrackOctaves() const noexcept { return keyTrackOctaves; }
+
+    //Audio thread, once per block. Keeps moved controllers for the next blocks and posts them on.
+    void publish() noexcept
+    {
+        if (pendingMask == 0)
+            return;
+
+        for (size_t i = 0; i < pendingValues.size(); i++)
+            if ((pendingMask & (1 << i)) != 0) {
+                rawValues[i]->store(pendingValues[i]);
+                postedValues[i].store(pendingValues[i]);
+                }
+
+        postedMask.fetch_or(pendingMask);
+        pendingMask = 0;
+    }
+
+private:
+
+    //message thread: the parameters catch up with what the audio thread already plays
+    void timerCallback() override
+    {
+        const auto mask = postedMask.exchange(0);
+
+        for (size_t i = 0; i < postedValues.size(); i++)
+            if ((mask & (1 << i)) != 0)
+                parameters[i]->setValueNotifyingHost(parameters[i]->convertTo0to1(postedValues[i].load()));
+    }
+
+    std::array<juce::RangedAudioParameter*, 4> parameters;
+    std::array<std::atomic<float>*, 4> rawValues;
+    std::array<Target, 128> ccTargets;
+    std::array<float, 4> pendingValues {};
+    int pendingMask = 0;
+    float keyTrackOctaves = 0.0f;
+
+    //written by publish(), read by the timer
+    std::array<std::atomic<float>, 4> postedValues {};
+    std::atomic<int> postedMask { 0 };
+};
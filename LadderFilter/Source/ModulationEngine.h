@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    ModulationEngine.h
+
+    Built-in LFO and input envelope follower driving cutoff, resonance and
+    drive. Both run at a control rate of one step every 8, 16 or 32 samples.
+    The processor interpolates between steps, so movement costs a few
+    operations per step rather than per sample. The follower tracks each
+    channel in its own lane and links them by taking the loudest, so both
+    channels share one set of filter coefficients.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class ModulationEngine
+{
+public:
+    enum class Shape { sine, triangle, saw, square };
+
+    //offsets in the units of the parameters they move, cutoff in octaves
+    struct Output
+    {
+        float cutoffOctaves = 0.0f;
+        float resonance = 0.0f;
+        float drive = 0.0f;
+    };
+
+    struct Settings
+    {
+        float lfoRate = 1.0f;
+        Shape lfoShape = Shape::sine;
+        Output lfoAmounts;
+
+        float attackMs = 10.0f;
+        float releaseMs = 200.0f;
+        Output envelopeAmounts;
+
+        int interval = 16;
+    };
+
+    static constexpr int maxChannels = 2;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        reset();
+    }
+
+    void reset()
+    {
+        phase = 0.0f;
+        envelopes.fill(0.0f);
+    }
+
+    //Audio thread, once per block
+    void setSettings(const Settings& newSettings) noexcept
+    {
+        settings = newSettings;
+
+        //the follower's one-poles step once per control interval
+        const auto intervalSeconds = settings.interval / sampleRate;
+        attackCoefficient = (float) std::exp(-intervalSeconds / juce::jmax(0.0001, settings.attackMs * 0.001));
+        releaseCoefficient = (float) std::exp(-intervalSeconds / juce::jmax(0.0001, settings.releaseMs * 0.001));
+    }
+
+    int getInterval() const noexcept { return settings.interval; }
+
+    //Nothing to do while every amount is zero
+    bool isActive() const noexcept
+    {
+        return isMoving(settings.lfoAmounts) || isMoving(settings.envelopeAmounts);
+    }
+
+    //Steps both sources over numSamples of dry input, at most one interval, and returns the offsets at its end
+    Output advance(const float* const* input, int numChannels, int numSamples) noexcept
+    {
+        numChannels = juce::jmin(numChannels, maxChannels);
+
+        //peak of each lane over the interval
+        std::array<float, maxChannels> peaks {};
+
+        for (int channel = 0; channel < numChannels; channel++) {
+            auto range = juce::FloatVectorOperations::findMinAndMax(input[channel], numSamples);
+            peaks[(size_t) channel] = juce::jmax(-range.getStart(), range.getEnd());
+            }
+
+        float linked = 0.0f;
+
+        for (size_t lane = 0; lane < maxChannels; lane++) {
+            const auto coefficient = peaks[lane] > envelopes[lane] ? attackCoefficient : releaseCoefficient;
+            envelopes[lane] = peaks[lane] + coefficient * (envelopes[lane] - peaks[lane]);
+            linked = juce::jmax(linked, envelopes[lane]);
+            }
+
+        //0 at -48 dBFS and below, 1 at full scale
+        const auto envelope = juce::jlimit(0.0f, 1.0f, juce::Decibels::gainToDecibels(linked, -48.0f) / 48.0f + 1.0f);
+
+        phase += settings.lfoRate * (float) (numSamples / sampleRate);
+        phase -= std::floor(phase);
+        const auto lfo = getLfoValue();
+
+        Output output;
+        output.cutoffOctaves = lfo * settings.lfoAmounts.cutoffOctaves + envelope * settings.envelopeAmounts.cutoffOctaves;
+        output.resonance = lfo * settings.lfoAmounts.resonance + envelope * settings.envelopeAmounts.resonance;
+        output.drive = lfo * settings.lfoAmounts.drive + envelope * settings.envelopeAmounts.drive;
+        return output;
+    }
+
+private:
+
+    static bool isMoving(const Output& amounts) noexcept
+    {
+        return amounts.cutoffOctaves != 0.0f || amounts.resonance != 0.0f || amounts.drive != 0.0f;
+    }
+
+    //bipolar, -1 to 1
+    float getLfoValue() const noexcept
+    {
+        switch (settings.lfoShape) {
+            case Shape::triangle: return 1.0f - 4.0f * std::abs(phase - 0.5f);
+            case Shape::saw: return 2.0f * phase - 1.0f;
+            case Shape::square: return phase < 0.5f ? 1.0f : -1.0f;
+            case Shape::sine: break;
+            }
+
+        return std::sin(juce::MathConstants<float>::twoPi * phase);
+    }
+
+    double sampleRate = 44100.0;
+    Settings settings;
+    float attackCoefficient = 0.0f, releaseCoefficient = 0.0f;
+
+    float phase = 0.0f;
+    std::array<float, maxChannels> envelopes {};
+};
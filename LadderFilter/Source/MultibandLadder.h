@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    MultibandLadder.h
+
+    Splits the input into 2 to 4 bands with Linkwitz-Riley crossovers and
+    gives each band its own drive, ladder and trim. Each band and channel
+    pair is one lane of a LadderLanes<8>, so every band of both channels
+    advances together. Lower bands also go through the allpass of each
+    crossover above them, which keeps the bands in phase so they sum flat.
+    All filters and buffers are set up in prepare().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../LadderCore/Source/LadderLanes.h"
+
+class MultibandLadder
+{
+public:
+    static constexpr int maxBands = 4;
+    static constexpr int maxChannels = 2;
+
+    using Lanes = LadderLanes<maxBands * maxChannels>;
+    using Settings = Lanes::Settings;
+
+    MultibandLadder()
+    {
+        for (auto& crossover : crossovers)
+            crossover.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+
+        for (auto& allpass : allpasses)
+            allpass.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+    }
+
+    //Not real-time safe. Call setCrossovers() afterwards, the split limits depend on the rate.
+    void prepare(double sampleRate, int maximumBlockSize)
+    {
+        juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) maximumBlockSize, (juce::uint32) maxChannels };
+
+        for (auto& crossover : crossovers)
+            crossover.prepare(spec);
+
+        for (auto& allpass : allpasses)
+            allpass.prepare(spec);
+
+        lanes.prepare(sampleRate);
+        frames.fill(0.0f);
+
+        //every split is set again on the next setCrossovers()
+        highestSplit = (float) juce::jmin(20000.0, 0.45 * sampleRate);
+        crossoverFrequencies.fill(0.0f);
+        numActiveSplits = 0;
+    }
+
+    void reset()
+    {
+        for (auto& crossover : crossovers)
+            crossover.reset();
+
+        for (auto& allpass : allpasses)
+            allpass.reset();
+
+        lanes.reset();
+    }
+
+    //Split points in Hz, low to high, for numBands bands; the splits above those aren't touched.
+    //Each split is kept a little above the one below it and at or under min(20 kHz, 0.45 fs),
+    //so the top one never reaches Nyquist however the parameters are set.
+    void setCrossovers(const std::array<float, maxBands - 1>& frequencies, int numBands)
+    {
+        const auto numSplits = juce::jlimit(1, maxBands - 1, numBands - 1);
+        auto lowest = 20.0f;
+
+        for (int split = 0; split < numSplits; split++) {
+            //leave room for the splits still to come above this one
+            const auto highest = juce::jmax(lowest, highestSplit / std::pow(splitSpacing, float (numSplits - 1 - split)));
+            const auto frequency = juce::jlimit(lowest, highest, frequencies[(size_t) split]);
+
+            //a split coming back in starts from silence, like the whole chain does
+            if (split >= numActiveSplits) {
+                crossovers[(size_t) split].reset();
+
+                for (int band = 0; band < split; band++)
+                    allpasses[getAllpassIndex(band, split)].reset();
+                }
+
+            if (frequency != crossoverFrequencies[(size_t) split]) {
+                crossoverFrequencies[(size_t) split] = frequency;
+                crossovers[(size_t) split].setCutoffFrequency(frequency);
+
+                //the allpasses that line lower bands up with this split
+                for (int band = 0; band < split; band++)
+                    allpasses[getAllpassIndex(band, split)].setCutoffFrequency(frequency);
+                }
+
+            lowest = frequency * splitSpacing;
+            }
+
+        numActiveSplits = numSplits;
+    }
+
+    void setBand(int band, const Settings& settings) noexcept
+    {
+        for (int channel = 0; channel < maxChannels; channel++)
+            lanes.setLane(band * maxChannels + channel, settings);
+    }
+
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, int numBands) noexcept
+    {
+        numBands = juce::jlimit(2, maxBands, numBands);
+        const auto numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+
+        for (int offset = 0; offset < numSamples; offset += chunkSize) {
+            const auto count = juce::jmin(chunkSize, numSamples - offset);
+
+            for (int channel = 0; channel < numChannels; channel++)
+                split(buffer.getReadPointer(channel, startSample + offset), channel, count, numBands);
+
+            lanes.process(frames.data(), count);
+
+            for (int channel = 0; channel < numChannels; channel++) {
+                auto* data = buffer.getWritePointer(channel, startSample + offset);
+
+                for (int i = 0; i < count; i++) {
+                    const auto* frame = frames.data() + (size_t) (i * Lanes::lanes + channel);
+                    float sum = 0.0f;
+
+                    for (int band = 0; band < numBands; band++)
+                        sum += frame[band * maxChannels];
+
+                    data[i] = sum;
+                    }
+                }
+            }
+    }
+
+private:
+
+    static constexpr int chunkSize = 64;
+
+    //smallest ratio between neighbouring splits
+    static constexpr float splitSpacing = 1.1f;
+
+    //allpass for a band below a split: (0, 1), (0, 2), (1, 2)
+    static int getAllpassIndex(int band, int split) noexcept { return split * (split - 1) / 2 + band; }
+
+    void split(const float* input, int channel, int count, int numBands) noexcept
+    {
+        const auto numSplits = numBands - 1;
+
+        for (int i = 0; i < count; i++) {
+            auto* frame = frames.data() + (size_t) (i * Lanes::lanes + channel);
+            auto remainder = input[i];
+
+            for (int split = 0; split < numSplits; split++) {
+                float low, high;
+                crossovers[split].processSample(channel, remainder, low, high);
+
+                for (int band = 0; band < split; band++)
+                    frame[band * maxChannels] = allpasses[getAllpassIndex(band, split)].processSample(channel, frame[band * maxChannels]);
+
+                frame[split * maxChannels] = low;
+                remainder = high;
+                }
+
+            frame[numSplits * maxChannels] = remainder;
+
+            //unused bands stay silent so their lanes settle
+            for (int band = numBands; band < maxBands; band++)
+                frame[band * maxChannels] = 0.0f;
+            }
+    }
+
+    std::array<juce::dsp::LinkwitzRileyFilter<float>, maxBands - 1> crossovers;
+    std::array<juce::dsp::LinkwitzRileyFilter<float>, 3> allpasses;
+    std::array<float, maxBands - 1> crossoverFrequencies {};
+    float highestSplit = 20000.0f;
+    int numActiveSplits = 0;
+
+    Lanes lanes;
+    std::array<float, chunkSize * Lanes::lanes> frames {};
+
+    JUCE_DECLARE_NON_COPYABLE (MultibandLadder)
+};
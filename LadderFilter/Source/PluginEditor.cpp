@@ -11,12 +11,8 @@
 
 //==============================================================================
 LadderFilterAudioProcessorEditor::LadderFilterAudioProcessorEditor (LadderFilterAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), analyzerView (p), responseView (p), audioProcessor (p)
 {
-    shadowProperties.radius = 24;
-    shadowProperties.offset = juce::Point<int> (-1, 3);
-    dialShadow.setShadowProperties (shadowProperties);
-            
     sliders.reserve(4);
     sliders = {
         &driveSlider, &cutoffSlider, &resoSlider, &trimSlider
@@ -40,14 +36,13 @@ LadderFilterAudioProcessorEditor::LadderFilterAudioProcessorEditor (LadderFilter
         sliders[i]->setColour(0x1001700, juce::Colour::fromFloatRGBA(1, 1, 1, 0.0f));
         sliders[i]->setColour(0x1001500, juce::Colour::fromFloatRGBA(0, 0, 0, 0.25f));
         sliders[i]->setLookAndFeel(&customDial);
-        sliders[i]->setComponentEffect(&dialShadow);
         }
             
     
-    driveSliderAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.treeState, driveSliderId, driveSlider);
-    resoSliderAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.treeState, resoDelaySliderId, resoSlider);
-    cutoffSliderAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.treeState, cutoffSliderId, cutoffSlider);
-    trimSliderAttach = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.treeState, trimSliderId, trimSlider);
+    driveSliderAttach = std::make_unique<ThrottledSliderAttachment>(audioProcessor.treeState, driveSliderId, driveSlider);
+    resoSliderAttach = std::make_unique<ThrottledSliderAttachment>(audioProcessor.treeState, resoDelaySliderId, resoSlider);
+    cutoffSliderAttach = std::make_unique<ThrottledSliderAttachment>(audioProcessor.treeState, cutoffSliderId, cutoffSlider);
+    trimSliderAttach = std::make_unique<ThrottledSliderAttachment>(audioProcessor.treeState, trimSliderId, trimSlider);
     
     driveSlider.setRange(0, 10, 0.25);
     driveSlider.setTextValueSuffix(" dB");
@@ -72,21 +67,87 @@ LadderFilterAudioProcessorEditor::LadderFilterAudioProcessorEditor (LadderFilter
     windowBorder.setText("The Ladder");
     windowBorder.setColour(0x1005400, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
     windowBorder.setColour(0x1005410, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+    
+    addAndMakeVisible(analyzerView);
+    addAndMakeVisible(responseView);
+    
+    const juce::String slotNames[] = { "A", "B", "C", "D" };
+    
+    for (auto i = 0; i < snapshotButtons.size(); i++) {
+        addAndMakeVisible(snapshotButtons[i]);
+        snapshotButtons[i].setButtonText(slotNames[i]);
+        snapshotButtons[i].setTooltip("Store the current settings in snapshot " + slotNames[i]);
+        snapshotButtons[i].setColour(0x1000100, juce::Colour::fromFloatRGBA(0, 0, 0, 0.25f));
+        snapshotButtons[i].setColour(0x1000102, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+        snapshotButtons[i].onClick = [this, i] { audioProcessor.snapshots.store(i, audioProcessor.getCurrentSnapshot()); };
+        }
+    
+    addAndMakeVisible(morphToggle);
+    morphToggle.setButtonText("Morph");
+    morphToggle.setColour(0x1006501, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+    morphToggleAttach = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.treeState, morphOnId, morphToggle);
+    
+    addAndMakeVisible(morphSlider);
+    morphSlider.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
+    morphSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    morphSlider.setColour(0x1001310, juce::Colour::fromFloatRGBA(0.392f, 0.584f, 0.929f, 0.5f));
+    morphSliderAttach = std::make_unique<ThrottledSliderAttachment>(audioProcessor.treeState, morphSliderId, morphSlider);
+    
+    for (auto* menu : { &morphFromMenu, &morphToMenu }) {
+        addAndMakeVisible(menu);
+        menu->addItemList(juce::StringArray (slotNames, SnapshotMorph::numSlots), 1);
+        menu->setColour(0x1000200, juce::Colour::fromFloatRGBA(0, 0, 0, 0.25f));
+        menu->setColour(0x1000c00, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+        }
+    
+    morphFromMenu.setTooltip("Snapshot the morph starts from");
+    morphToMenu.setTooltip("Snapshot the morph ends on");
+    morphFromMenuAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.treeState, morphFromId, morphFromMenu);
+    morphToMenuAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.treeState, morphToId, morphToMenu);
+    
+    addAndMakeVisible(modeMenu);
+    modeMenu.addItemList(audioProcessor.treeState.getParameter(filterModeId)->getAllValueStrings(), 1);
+    modeMenu.setColour(0x1000200, juce::Colour::fromFloatRGBA(0, 0, 0, 0.25f));
+    modeMenu.setColour(0x1000c00, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+    modeMenuAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.treeState, filterModeId, modeMenu);
             
     //Making the window resizable by aspect ratio and setting size
     AudioProcessorEditor::setResizable(true, true);
-    AudioProcessorEditor::setResizeLimits(600, 200, 900, 300);
-    AudioProcessorEditor::getConstrainer()->setFixedAspectRatio(3.0);
-    setSize (750, 250);
+    AudioProcessorEditor::setResizeLimits(600, 320, 900, 480);
+    AudioProcessorEditor::getConstrainer()->setFixedAspectRatio(1.875);
+    setSize (750, 400);
+    
+    //the cached background covers every pixel
+    setOpaque(true);
+    
+    startTimerHz(uiFrameRate);
 }
 
 LadderFilterAudioProcessorEditor::~LadderFilterAudioProcessorEditor()
 {
+    stopTimer();
 }
 
 //==============================================================================
 void LadderFilterAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    
+    if (! backgroundImage.isValid() || scale != backgroundScale)
+        renderBackground(scale);
+    
+    g.setOpacity(1.0f);
+    g.drawImage(backgroundImage, getLocalBounds().toFloat());
+}
+
+void LadderFilterAudioProcessorEditor::renderBackground(float scale)
+{
+    backgroundScale = scale;
+    backgroundImage = juce::Image (juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)), juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+    
+    juce::Graphics g (backgroundImage);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    
     g.fillAll (juce::Colour::fromFloatRGBA(0.1f, 0.12f, 0.16f, 1.0));
                    
     juce::Rectangle<int> background = AudioProcessorEditor::getLocalBounds();
@@ -94,10 +155,37 @@ void LadderFilterAudioProcessorEditor::paint (juce::Graphics& g)
     g.fillRect(background);
 }
 
+void LadderFilterAudioProcessorEditor::timerCallback()
+{
+    for (auto* attachment : { driveSliderAttach.get(), cutoffSliderAttach.get(), resoSliderAttach.get(), trimSliderAttach.get(), morphSliderAttach.get() })
+        attachment->flush();
+}
+
 void LadderFilterAudioProcessorEditor::resized()
 {
+    //regenerated on the next paint at the right scale
+    backgroundImage = juce::Image();
+    
     //Master bounds object
        juce::Rectangle<int> bounds = getLocalBounds();
+    
+    //analyzer strip across the top, dials underneath
+    auto analyzerArea = bounds.removeFromTop(bounds.getHeight() * 0.4);
+    analyzerView.setBounds(analyzerArea.reduced(getWidth() * 0.03, 0).withTrimmedTop(getHeight() * 0.1).withTrimmedBottom(getHeight() * 0.02));
+    responseView.setBounds(analyzerView.getBounds());
+    
+    //snapshot row along the bottom, inside the border
+    auto snapshotRow = bounds.removeFromBottom(bounds.getHeight() * 0.2).reduced(getWidth() * 0.03, 0).withTrimmedBottom(getHeight() * 0.08);
+    auto buttonWidth = snapshotRow.getHeight() * 1.5;
+    
+    for (auto& button : snapshotButtons)
+        button.setBounds(snapshotRow.removeFromLeft(buttonWidth).reduced(2));
+    
+    morphToggle.setBounds(snapshotRow.removeFromLeft(buttonWidth * 2).reduced(2));
+    modeMenu.setBounds(snapshotRow.removeFromRight(buttonWidth * 2.5).reduced(2));
+    morphFromMenu.setBounds(snapshotRow.removeFromLeft(buttonWidth * 1.5).reduced(2));
+    morphToMenu.setBounds(snapshotRow.removeFromRight(buttonWidth * 1.5).reduced(2));
+    morphSlider.setBounds(snapshotRow.reduced(2));
 
        //first column of gui
        juce::FlexBox flexboxColumnOne;
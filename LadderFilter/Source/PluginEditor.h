@@ -10,6 +10,9 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ThrottledSliderAttachment.h"
+#include "AnalyzerComponent.h"
+#include "ResponseCurveComponent.h"
 
 //==============================================================================
 /**
@@ -17,31 +20,91 @@
 
 class ViatorDial : public juce::LookAndFeel_V4{
 public:
+    ViatorDial(){
+        dialShadow.radius = 24;
+        dialShadow.offset = juce::Point<int> (-1, 3);
+    }
+    
     void drawRotarySlider(juce::Graphics &g, int x, int y, int width, int height, float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider &slider) override{
         
         float diameter = fmin(width, height) * 0.65;
         float radius = diameter * 0.5;
         float centerX = x + width * 0.5;
         float centerY = y + height * 0.5;
-        float rx = centerX - radius;
-        float ry = centerY - radius;
         float angle = rotaryStartAngle + (sliderPos * (rotaryEndAngle - rotaryStartAngle));
         
-        juce::Rectangle<float> dialArea (rx, ry, diameter, diameter);
-        g.setColour(juce::Colour::fromFloatRGBA(0.15, 0.15, 0.15, 1)); //center
-        g.setGradientFill(juce::ColourGradient::horizontal(juce::Colour::fromFloatRGBA(0.1, 0.1, 0.1, 1), centerY * .25, juce::Colour::fromFloatRGBA(0.15, 0.15, 0.15, 1), centerY * 2.5));
-        g.fillEllipse(dialArea);
+        //body, outline and shadow never change with the value, so they come from the cache
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        g.setOpacity(1.0f);
+        g.drawImage(getDialBody(x, y, width, height, scale), juce::Rectangle<int> (x, y, width, height).expanded(getShadowPadding()).toFloat());
+        
         g.setColour(juce::Colour::fromFloatRGBA(0.392f, 0.584f, 0.929f, 0.5f)); //tick color
 
         juce::Path dialTick;
         dialTick.addRectangle(0, -radius + 3, 3.0f, radius * 0.452211);
         g.fillPath(dialTick, juce::AffineTransform::rotation(angle).translated(centerX, centerY));
-        g.setColour(juce::Colour::fromFloatRGBA(0, 0, 0, .25)); //outline
-        g.drawEllipse(rx, ry, diameter, diameter, 1.0f);
     }
+    
+private:
+    
+    struct DialBody {
+        juce::Rectangle<int> area;
+        float scale;
+        juce::Image image;
+    };
+    
+    //Renders the static part of the dial at physical resolution, once per size and scale
+    const juce::Image& getDialBody(int x, int y, int width, int height, float scale){
+        
+        juce::Rectangle<int> area (x, y, width, height);
+        
+        for (auto& body : dialBodies) {
+            if (body.area == area && body.scale == scale)
+                return body.image;
+            }
+        
+        //sizes only change while the window is being dragged, so a handful of entries is plenty
+        if (dialBodies.size() >= maxCachedBodies)
+            dialBodies.erase(dialBodies.begin());
+        
+        //the shadow spreads past the dial's bounds, so the image is padded to hold all of it
+        auto padded = area.expanded(getShadowPadding());
+        juce::Image image (juce::Image::ARGB, juce::jmax(1, juce::roundToInt(padded.getWidth() * scale)), juce::jmax(1, juce::roundToInt(padded.getHeight() * scale)), true);
+        juce::Graphics ig (image);
+        ig.addTransform(juce::AffineTransform::translation(-padded.getX(), -padded.getY()).scaled(scale));
+        
+        float diameter = fmin(width, height) * 0.65;
+        float radius = diameter * 0.5;
+        float centerX = x + width * 0.5;
+        float centerY = y + height * 0.5;
+        float rx = centerX - radius;
+        float ry = centerY - radius;
+        
+        juce::Rectangle<float> dialArea (rx, ry, diameter, diameter);
+        
+        juce::Path dialOutline;
+        dialOutline.addEllipse(dialArea);
+        dialShadow.drawForPath(ig, dialOutline);
+        
+        ig.setGradientFill(juce::ColourGradient::horizontal(juce::Colour::fromFloatRGBA(0.1, 0.1, 0.1, 1), centerY * .25, juce::Colour::fromFloatRGBA(0.15, 0.15, 0.15, 1), centerY * 2.5));
+        ig.fillEllipse(dialArea);
+        ig.setColour(juce::Colour::fromFloatRGBA(0, 0, 0, .25)); //outline
+        ig.drawEllipse(rx, ry, diameter, diameter, 1.0f);
+        
+        dialBodies.push_back({ area, scale, image });
+        return dialBodies.back().image;
+    }
+    
+    int getShadowPadding() const{
+        return dialShadow.radius + juce::jmax(std::abs(dialShadow.offset.x), std::abs(dialShadow.offset.y));
+    }
+    
+    static constexpr size_t maxCachedBodies = 8;
+    std::vector<DialBody> dialBodies;
+    juce::DropShadow dialShadow;
 };
 
-class LadderFilterAudioProcessorEditor  : public juce::AudioProcessorEditor
+class LadderFilterAudioProcessorEditor  : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     LadderFilterAudioProcessorEditor (LadderFilterAudioProcessor&);
@@ -53,11 +116,34 @@ public:
 
 private:
     
+    void timerCallback() override;
+    void renderBackground(float scale);
+    
+    //parameter driven repaints are coalesced to this rate
+    static constexpr int uiFrameRate = 30;
+    
     juce::Slider driveSlider, cutoffSlider, resoSlider, trimSlider;
     std::vector<juce::Slider*> sliders;
-    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> driveSliderAttach, cutoffSliderAttach, resoSliderAttach, trimSliderAttach;
+    std::unique_ptr <ThrottledSliderAttachment> driveSliderAttach, cutoffSliderAttach, resoSliderAttach, trimSliderAttach;
             
     juce::GroupComponent windowBorder;
+    AnalyzerComponent analyzerView;
+    ResponseCurveComponent responseView;
+    
+    //snapshot store buttons and the morph between two of them
+    std::array<juce::TextButton, SnapshotMorph::numSlots> snapshotButtons;
+    juce::ToggleButton morphToggle;
+    juce::Slider morphSlider;
+    std::unique_ptr <ThrottledSliderAttachment> morphSliderAttach;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ButtonAttachment> morphToggleAttach;
+    
+    //the two snapshots the morph runs between, either side of the morph slider
+    juce::ComboBox morphFromMenu, morphToMenu;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> morphFromMenuAttach, morphToMenuAttach;
+    
+    //filter mode, at the end of the snapshot row
+    juce::ComboBox modeMenu;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeMenuAttach;
             
     juce::Label driveLabel, cutoffLabel, resoLabel, trimLabel;
     std::vector<juce::Label*> labels;
@@ -69,8 +155,9 @@ private:
     std::vector<std::string> labelTexts;
             
     ViatorDial customDial;
-    juce::DropShadow shadowProperties;
-    juce::DropShadowEffect dialShadow;
+    
+    juce::Image backgroundImage;
+    float backgroundScale = 0.0f;
     
     LadderFilterAudioProcessor& audioProcessor;
 
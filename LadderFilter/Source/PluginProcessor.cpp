@@ -8,6 +8,46 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RackProcessor.h"
+
+namespace
+{
+    //drive, cutoff, resonance and trim of each band
+    const char* const bandParameterIds[MultibandLadder::maxBands][4] = {
+        { band1DriveId, band1CutoffId, band1ResonanceId, band1TrimId },
+        { band2DriveId, band2CutoffId, band2ResonanceId, band2TrimId },
+        { band3DriveId, band3CutoffId, band3ResonanceId, band3TrimId },
+        { band4DriveId, band4CutoffId, band4ResonanceId, band4TrimId }
+    };
+    
+    bool isOneOf(const char* parameterId, std::initializer_list<const char*> ids)
+    {
+        return std::any_of(ids.begin(), ids.end(), [parameterId] (const char* id) { return std::strcmp(id, parameterId) == 0; });
+    }
+    
+    //choices and switches change over halfway, frequencies move in octaves, the morph's own controls stay put
+    SnapshotMorph::Interpolations getMorphInterpolations(juce::AudioProcessorValueTreeState& treeState)
+    {
+        SnapshotMorph::Interpolations interpolations;
+        
+        for (int i = 0; i < PresetFormat::numParameters; i++) {
+            const auto* id = PresetFormat::parameterIds[i];
+            auto* parameter = treeState.getParameter(id);
+            auto& interpolation = interpolations[(size_t) i];
+            
+            if (isOneOf(id, { morphOnId, morphSliderId, morphFromId, morphToId }))
+                interpolation = SnapshotMorph::Interpolation::none;
+            else if (dynamic_cast<juce::AudioParameterChoice*>(parameter) != nullptr || dynamic_cast<juce::AudioParameterBool*>(parameter) != nullptr)
+                interpolation = SnapshotMorph::Interpolation::step;
+            else if (isOneOf(id, { cutoffSliderId, crossover1Id, crossover2Id, crossover3Id, band1CutoffId, band2CutoffId, band3CutoffId, band4CutoffId, sideCutoffId }))
+                interpolation = SnapshotMorph::Interpolation::logarithmic;
+            else
+                interpolation = SnapshotMorph::Interpolation::linear;
+        }
+        
+        return interpolations;
+    }
+}
 
 //==============================================================================
 LadderFilterAudioProcessor::LadderFilterAudioProcessor()
@@ -16,34 +56,113 @@ LadderFilterAudioProcessor::LadderFilterAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ),
-treeState (*this, nullptr, "PARAMETER", createParameterLayout())
+treeState (*this, nullptr, "PARAMETER", createParameterLayout()),
+snapshots (getDefaultValues(), getMorphInterpolations(treeState)),
+presetBank (PresetBank::getInstance(getDefaultValues())),
+saturation (SharedTables::getSaturation()),
+midiControl ({ treeState.getParameter(driveSliderId), treeState.getParameter(cutoffSliderId),
+               treeState.getParameter(resoDelaySliderId), treeState.getParameter(trimSliderId) },
+             { treeState.getRawParameterValue(driveSliderId), treeState.getRawParameterValue(cutoffSliderId),
+               treeState.getRawParameterValue(resoDelaySliderId), treeState.getRawParameterValue(trimSliderId) })
 #endif
 {
+    for (int i = 0; i < PresetFormat::numParameters; i++)
+        rawValues[(size_t) i] = treeState.getRawParameterValue(PresetFormat::parameterIds[i]);
 }
 
 LadderFilterAudioProcessor::~LadderFilterAudioProcessor()
 {
+    //a decode still running touches the parameter layout and would post an update, so it stops first
+    backgroundJobs.cancelAndWait();
+    cancelPendingUpdate();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout LadderFilterAudioProcessor::createParameterLayout()
 {
     std::vector <std::unique_ptr<juce::RangedAudioParameter>> params;
-    params.reserve(4);
+    params.reserve(47);
     
     
     auto driveParam = std::make_unique<juce::AudioParameterFloat>(driveSliderId, driveSliderName, 0.0, 10.0, 0.0);
     auto cutoffParam = std::make_unique<juce::AudioParameterInt>(cutoffSliderId, cutoffSliderName, 20, 20000, 750);
     auto resoParam = std::make_unique<juce::AudioParameterFloat>(resoDelaySliderId, resoDelaySliderName, 0.0, 1.0, 0.5);
     auto trimParam = std::make_unique<juce::AudioParameterFloat>(trimSliderId, trimSliderName, -36.0, 36.0, 0.0);
+    
+    const juce::StringArray slotNames { "A", "B", "C", "D" };
+    auto morphOnParam = std::make_unique<juce::AudioParameterBool>(morphOnId, morphOnName, false);
+    auto morphParam = std::make_unique<juce::AudioParameterFloat>(morphSliderId, morphSliderName, 0.0, 1.0, 0.0);
+    auto morphFromParam = std::make_unique<juce::AudioParameterChoice>(morphFromId, morphFromName, slotNames, 0);
+    auto morphToParam = std::make_unique<juce::AudioParameterChoice>(morphToId, morphToName, slotNames, 1);
+    auto keyTrackParam = std::make_unique<juce::AudioParameterFloat>(keyTrackId, keyTrackName, 0.0, 1.0, 0.0);
+    auto sidechainDepthParam = std::make_unique<juce::AudioParameterFloat>(sidechainDepthId, sidechainDepthName, -4.0, 4.0, 0.0);
+    
+    //modulation amounts are in the units of their destination, cutoff in octaves
+    const juce::StringArray shapeNames { "Sine", "Triangle", "Saw", "Square" };
+    auto lfoRateParam = std::make_unique<juce::AudioParameterFloat>(lfoRateId, lfoRateName, juce::NormalisableRange<float> (0.05f, 20.0f, 0.0f, 0.3f), 1.0f);
+    auto lfoShapeParam = std::make_unique<juce::AudioParameterChoice>(lfoShapeId, lfoShapeName, shapeNames, 0);
+    auto lfoCutoffParam = std::make_unique<juce::AudioParameterFloat>(lfoCutoffId, lfoCutoffName, -4.0, 4.0, 0.0);
+    auto lfoResonanceParam = std::make_unique<juce::AudioParameterFloat>(lfoResonanceId, lfoResonanceName, -1.0, 1.0, 0.0);
+    auto lfoDriveParam = std::make_unique<juce::AudioParameterFloat>(lfoDriveId, lfoDriveName, -10.0, 10.0, 0.0);
+    auto envAttackParam = std::make_unique<juce::AudioParameterFloat>(envAttackId, envAttackName, juce::NormalisableRange<float> (0.1f, 100.0f, 0.0f, 0.4f), 10.0f);
+    auto envReleaseParam = std::make_unique<juce::AudioParameterFloat>(envReleaseId, envReleaseName, juce::NormalisableRange<float> (5.0f, 2000.0f, 0.0f, 0.4f), 200.0f);
+    auto envCutoffParam = std::make_unique<juce::AudioParameterFloat>(envCutoffId, envCutoffName, -4.0, 4.0, 0.0);
+    auto envResonanceParam = std::make_unique<juce::AudioParameterFloat>(envResonanceId, envResonanceName, -1.0, 1.0, 0.0);
+    auto envDriveParam = std::make_unique<juce::AudioParameterFloat>(envDriveId, envDriveName, -10.0, 10.0, 0.0);
+    auto controlRateParam = std::make_unique<juce::AudioParameterChoice>(controlRateId, controlRateName, juce::StringArray { "8", "16", "32" }, 1);
+    
+    //in LadderKernel::Mode order, LP 12 is what the plugin always used
+    auto filterModeParam = std::make_unique<juce::AudioParameterChoice>(filterModeId, filterModeName, juce::StringArray { "LP 12", "HP 12", "BP 12", "LP 24", "HP 24", "BP 24" }, 0);
 
     params.push_back(std::move(driveParam));
     params.push_back(std::move(cutoffParam));
     params.push_back(std::move(resoParam));
     params.push_back(std::move(trimParam));
+    params.push_back(std::move(morphOnParam));
+    params.push_back(std::move(morphParam));
+    params.push_back(std::move(morphFromParam));
+    params.push_back(std::move(morphToParam));
+    params.push_back(std::move(keyTrackParam));
+    params.push_back(std::move(sidechainDepthParam));
+    params.push_back(std::move(lfoRateParam));
+    params.push_back(std::move(lfoShapeParam));
+    params.push_back(std::move(lfoCutoffParam));
+    params.push_back(std::move(lfoResonanceParam));
+    params.push_back(std::move(lfoDriveParam));
+    params.push_back(std::move(envAttackParam));
+    params.push_back(std::move(envReleaseParam));
+    params.push_back(std::move(envCutoffParam));
+    params.push_back(std::move(envResonanceParam));
+    params.push_back(std::move(envDriveParam));
+    params.push_back(std::move(controlRateParam));
+    params.push_back(std::move(filterModeParam));
+    
+    //1 band is the single chain above, the crossovers and band chains only run with 2 or more
+    const juce::NormalisableRange<float> frequencyRange (20.0f, 20000.0f, 0.0f, 0.25f);
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(bandsId, bandsName, juce::StringArray { "1", "2", "3", "4" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(crossover1Id, crossover1Name, frequencyRange, 200.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(crossover2Id, crossover2Name, frequencyRange, 1000.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(crossover3Id, crossover3Name, frequencyRange, 5000.0f));
+    
+    for (int band = 0; band < MultibandLadder::maxBands; band++) {
+        const auto& ids = bandParameterIds[band];
+        const auto name = "Band " + juce::String (band + 1) + " ";
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(ids[0], name + driveSliderName, 0.0f, 10.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(ids[1], name + cutoffSliderName, frequencyRange, 20000.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(ids[2], name + resoDelaySliderName, 0.0f, 1.0f, 0.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(ids[3], name + trimSliderName, -36.0f, 36.0f, 0.0f));
+    }
+    
+    //the main controls set mid or left, these set side or right, with the same ranges
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(stereoModeId, stereoModeName, juce::StringArray { "Linked", "Mid/Side", "Left/Right" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(sideDriveId, sideDriveName, 0.0, 10.0, 0.0));
+    params.push_back(std::make_unique<juce::AudioParameterInt>(sideCutoffId, sideCutoffName, 20, 20000, 750));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(sideResonanceId, sideResonanceName, 0.0, 1.0, 0.5));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(sideTrimId, sideTrimName, -36.0, 36.0, 0.0));
     
     return { params.begin(), params.end() };
 }
@@ -88,21 +207,35 @@ double LadderFilterAudioProcessor::getTailLengthSeconds() const
 
 int LadderFilterAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return juce::jmax(1, presetBank->size());   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                                // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int LadderFilterAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
 void LadderFilterAudioProcessor::setCurrentProgram (int index)
 {
+    if (! juce::isPositiveAndBelow(index, presetBank->size()))
+        return;
+    
+    //already decoded, so this is safe from whatever thread the host uses
+    currentProgram = index;
+    const auto& values = (*presetBank)[index].values;
+    
+    for (int i = 0; i < PresetFormat::numParameters; i++) {
+        auto* parameter = treeState.getParameter(PresetFormat::parameterIds[i]);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(values[(size_t) i]));
+    }
 }
 
 const juce::String LadderFilterAudioProcessor::getProgramName (int index)
 {
+    if (juce::isPositiveAndBelow(index, presetBank->size()))
+        return (*presetBank)[index].name;
+    
     return {};
 }
 
@@ -113,21 +246,61 @@ void LadderFilterAudioProcessor::changeProgramName (int index, const juce::Strin
 //==============================================================================
 void LadderFilterAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    //a session restored just before has to be in place for the first block
+    applyPendingState();
+    updateBlockValues();
+    
+    chunkSize = juce::jmax(minChunkSize, samplesPerBlock);
+    
     juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
+    spec.maximumBlockSize = (juce::uint32) chunkSize;
     spec.sampleRate = sampleRate;
     spec.numChannels = getTotalNumOutputChannels();
     
-    ladderProcessor.prepare(spec);
-    ladderProcessor.setDrive(1.0);
+    //a rate seen before has its cutoff table ready; keyed on the channels the ladder is prepared with
+    prepareCache.prepare({ sampleRate, samplesPerBlock, getMainBusNumOutputChannels() });
+    
+    kernels = &CpuDispatch::getKernels();
+    ladderProcessor.prepare(sampleRate, getMainBusNumOutputChannels());
+    ladderProcessor.setDrive(1.0f);
     
     trimProcessor.prepare(spec);
+    trimProcessor.setRampDurationSeconds(rampSeconds);
+    
+    const float drive = value(driveSliderId) * 5;
+    inputGainSmoother.reset(sampleRate, rampSeconds);
+    inputGainSmoother.setCurrentAndTargetValue(pow(10, drive * 0.05f));
+    outputGainSmoother.reset(sampleRate, rampSeconds);
+    outputGainSmoother.setCurrentAndTargetValue(piDivisor * 1.5f * pow(10, (-1 * drive) * 0.04f));
+    sidechainDepthSmoother.reset(sampleRate, rampSeconds);
+    sidechainDepthSmoother.setCurrentAndTargetValue(value(sidechainDepthId));
+    
+    modulation.prepare(sampleRate);
+    lastModulation = {};
+    
+    //all the crossover and allpass state is allocated here, never on the audio thread
+    multiband.prepare(sampleRate, chunkSize);
+    updateMultiband();
+    multiband.reset();
+    stereoLadder.prepare(sampleRate);
+    
+    //forces every coefficient to be set on the first segment
+    lastSettings = { -1.0f, -1.0f, -1.0f, -100.0f };
 }
 
 void LadderFilterAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    if (releasePolicy == PrepareCache::ReleasePolicy::keepEverything)
+        return;
+    
+    //The ladder's channel state is the only buffer freed here, it passes audio through untouched
+    //until the next prepareToPlay. The multiband and stereo chains hold their state inline and the
+    //crossovers only a few floats per channel. The analyzer FIFO stays: the editor's analyzer
+    //thread may read it whether or not the host is playing.
+    ladderProcessor.release();
+    
+    if (releasePolicy == PrepareCache::ReleasePolicy::freeEverything)
+        prepareCache.clear();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -149,6 +322,16 @@ bool LadderFilterAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+    
+    // The sidechain is optional, and only its level is used
+    if (layouts.inputBuses.size() > 1) {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+        
+        if (! sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -162,34 +345,339 @@ void LadderFilterAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    //some hosts pass fewer channels than the layout has
+    for (auto i = totalNumInputChannels; i < juce::jmin(totalNumOutputChannels, buffer.getNumChannels()); ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    auto* rawDrive = treeState.getRawParameterValue(driveSliderId);
-    auto* rawCutoff = treeState.getRawParameterValue(cutoffSliderId);
-    auto* rawReso = treeState.getRawParameterValue(resoDelaySliderId);
-    auto* rawTrim = treeState.getRawParameterValue(trimSliderId);
-
-    for (int channel = 0; channel < totalNumInputChannels; ++channel){
-        auto* outputData = buffer.getWritePointer (channel);
-        auto* inputData = buffer.getReadPointer(channel);
+    //the sidechain's channels follow the main input's in the buffer, keep them apart
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+    const auto sidechain = getBusCount(true) > 1 ? getBusBuffer(buffer, true, 1) : juce::AudioBuffer<float> ();
+    
+    updateBlockValues();
+    ChainSettings settings { value(driveSliderId), value(cutoffSliderId), value(resoDelaySliderId), value(trimSliderId) };
+    
+    modulation.setSettings(getModulationSettings());
+    
+    //crossfades inside the kernel when it changes
+    ladderProcessor.setMode((LadderKernel::Mode) (int) value(filterModeId));
+    
+    //the single chain's ladder and, in stereo mode, its trim sit idle while another chain runs
+    const bool singleChainWasActive = ! multibandActive && stereoMode == 0;
+    
+    //bands start from silence each time the multiband chain comes back in
+    const bool multibandOn = getNumBands() > 1;
+    
+    if (multibandOn) {
+        if (! multibandActive)
+            multiband.reset();
+        
+        updateMultiband();
+        }
+    
+    multibandActive = multibandOn;
+    
+    //the unlinked modes need a stereo pair
+    const auto newStereoMode = mainBuffer.getNumChannels() >= 2 ? (int) value(stereoModeId) : 0;
+    
+    if (newStereoMode != 0 && stereoMode == 0)
+        stereoLadder.reset();
+    
+    stereoMode = newStereoMode;
+    
+    //so the single chain comes back from silence, with the trim already at its value
+    if (! singleChainWasActive && ! multibandActive && stereoMode == 0) {
+        ladderProcessor.reset();
+        trimProcessor.reset();
+        }
+    
+    //split the block where MIDI changes something, so changes land on their sample
+    const auto numSamples = buffer.getNumSamples();
+    int segmentStart = 0;
+    
+    for (const auto metadata : midiMessages) {
+        const auto position = juce::jlimit(0, numSamples, metadata.samplePosition);
         
-        for (int sample = 0; sample < buffer.getNumSamples(); sample++) {
-            outputData[sample] = softClip(inputData[sample], *rawDrive * 5);
+        //Events on the same sample share a split. A split only works out the coefficients of
+        //values that moved, so a dense CC stream costs a recalculation per event, not a block setup.
+        if (position > segmentStart) {
+            processSegment(mainBuffer, sidechain, segmentStart, position - segmentStart, settings);
+            segmentStart = position;
         }
+        
+        midiControl.handle(metadata.getMessage(), settings);
     }
     
-    juce::dsp::AudioBlock<float> audioBlock {buffer};
+    processSegment(mainBuffer, sidechain, segmentStart, numSamples - segmentStart, settings);
+    midiControl.publish();
+    
+    analyzerFifo.push(mainBuffer);
+}
 
-    ladderProcessor.setCutoffFrequencyHz(*rawCutoff);
-    ladderProcessor.setResonance(*rawReso);
+void LadderFilterAudioProcessor::processSegment (juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples, const ChainSettings& settings)
+{
+    //only the first chunk finds settings that moved, the rest carry on with the same ramps
+    for (int offset = 0; offset < numSamples; offset += chunkSize)
+        processChunk(buffer, sidechain, startSample + offset, juce::jmin(chunkSize, numSamples - offset), settings);
+}
+
+void LadderFilterAudioProcessor::processChunk (juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples, const ChainSettings& settings)
+{
+    const auto totalNumInputChannels = buffer.getNumChannels();
+    const bool modulating = modulation.isActive();
+    
+    //when the modulation stops, the drive gains ramp back from wherever it left them
+    if (wasModulating && ! modulating)
+        lastSettings.drive = -1.0f;
+    
+    wasModulating = modulating;
+    
+    //coefficients are only recalculated for values that actually moved
+    if (settings.drive != lastSettings.drive) {
+        //softClip's gains only depend on the drive, so work them out once per change
+        const float drive = settings.drive * 5;
+        inputGainSmoother.setTargetValue(pow(10, drive * 0.05f));
+        outputGainSmoother.setTargetValue(piDivisor * 1.5f * pow(10, (-1 * drive) * 0.04f));
+    }
+    
+    const float keyTrack = value(keyTrackId);
+    const float cutoff = juce::jlimit(20.0f, 20000.0f, settings.cutoff * std::exp2(keyTrack * midiControl.getKeyTrackOctaves()));
+    
+    if (cutoff != lastSettings.cutoff)
+        ladderProcessor.setCutoffFrequencyHz(cutoff);
     
-    trimProcessor.setGainDecibels(*rawTrim);
+    if (settings.resonance != lastSettings.resonance)
+        ladderProcessor.setResonance(settings.resonance);
+    
+    if (settings.trim != lastSettings.trim)
+        trimProcessor.setGainDecibels(settings.trim);
+    
+    lastSettings = { settings.drive, cutoff, settings.resonance, settings.trim };
+    sidechainDepthSmoother.setTargetValue(value(sidechainDepthId));
+    
+    if (multibandActive) {
+        //the bands have their own drive, ladder and trim, the single chain's ramps carry on underneath.
+        //The main trim below still applies, as an output level over the summed bands.
+        inputGainSmoother.skip(numSamples);
+        outputGainSmoother.skip(numSamples);
+        multiband.process(buffer, startSample, numSamples, getNumBands());
+        }
+    else if (stereoMode != 0) {
+        //each side has its own trim, so the shared trim below is left out
+        inputGainSmoother.skip(numSamples);
+        outputGainSmoother.skip(numSamples);
+        processStereoSegment(buffer, startSample, numSamples, { settings.drive, cutoff, settings.resonance, settings.trim });
+        return;
+        }
+    else if (modulating) {
+        processModulatedSegment(buffer, sidechain, startSample, numSamples, settings.drive);
+        }
+    else {
+        lastModulation = {};
         
-    ladderProcessor.process(juce::dsp::ProcessContextReplacing<float> (audioBlock));
+        if (inputGainSmoother.isSmoothing() || outputGainSmoother.isSmoothing()) {
+            for (int sample = startSample; sample < startSample + numSamples; sample++) {
+                const float inputGain = inputGainSmoother.getNextValue();
+                const float outputGain = outputGainSmoother.getNextValue();
+                
+                for (int channel = 0; channel < totalNumInputChannels; ++channel) {
+                    auto* data = buffer.getWritePointer (channel);
+                    data[sample] = saturation->atan(inputGain * data[sample]) * outputGain;
+                }
+            }
+        }
+        else {
+            const float inputGain = inputGainSmoother.getTargetValue();
+            const float outputGain = outputGainSmoother.getTargetValue();
+            
+            for (int channel = 0; channel < totalNumInputChannels; ++channel)
+                kernels->saturate(buffer.getWritePointer (channel, startSample), numSamples, saturation->getAtanValues(), inputGain, outputGain);
+        }
+        
+        //without a sidechain signal or depth the cutoff only moves at control rate
+        if (isSidechainActive(sidechain)) {
+            processModulatedLadder(buffer, sidechain, startSample, numSamples);
+            }
+        else {
+            std::array<float*, 2> channels {};
+            
+            for (int channel = 0; channel < juce::jmin(totalNumInputChannels, 2); channel++)
+                channels[(size_t) channel] = buffer.getWritePointer(channel, startSample);
+            
+            ladderProcessor.process(channels.data(), juce::jmin(totalNumInputChannels, 2), numSamples);
+            }
+        }
+    
+    auto audioBlock = juce::dsp::AudioBlock<float> (buffer).getSubBlock((size_t) startSample, (size_t) numSamples);
     trimProcessor.process(juce::dsp::ProcessContextReplacing<float> (audioBlock));
 }
 
+void LadderFilterAudioProcessor::processModulatedSegment (juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples, float drive)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), 2);
+    const bool sidechainActive = isSidechainActive(sidechain);
+    std::array<float*, 2> channels {};
+    
+    for (int offset = 0; offset < numSamples; offset += modulation.getInterval()) {
+        const auto count = juce::jmin(modulation.getInterval(), numSamples - offset);
+        
+        for (int channel = 0; channel < numChannels; channel++)
+            channels[(size_t) channel] = buffer.getWritePointer(channel, startSample + offset);
+        
+        //the follower listens to the dry input, so this comes before the drive
+        const auto output = modulation.advance(channels.data(), numChannels, count);
+        
+        //drive gains are worked out once per interval and interpolated across it
+        const float modulatedDrive = juce::jlimit(0.0f, 10.0f, drive + output.drive) * 5;
+        const float inputGain = inputGainSmoother.getCurrentValue();
+        const float outputGain = outputGainSmoother.getCurrentValue();
+        const float inputStep = (pow(10, modulatedDrive * 0.05f) - inputGain) / count;
+        const float outputStep = (piDivisor * 1.5f * pow(10, (-1 * modulatedDrive) * 0.04f) - outputGain) / count;
+        
+        for (int channel = 0; channel < numChannels; channel++) {
+            auto* data = channels[(size_t) channel];
+            
+            for (int sample = 0; sample < count; sample++)
+                data[sample] = saturation->atan((inputGain + inputStep * (sample + 1)) * data[sample]) * (outputGain + outputStep * (sample + 1));
+        }
+        
+        inputGainSmoother.setCurrentAndTargetValue(inputGain + inputStep * count);
+        outputGainSmoother.setCurrentAndTargetValue(outputGain + outputStep * count);
+        
+        if (sidechainActive) {
+            //the sidechain stays audio rate, the control-rate offset is interpolated under it
+            fillSidechainOctaves(sidechain, startSample + offset, count);
+            const auto step = (output.cutoffOctaves - lastModulation.cutoffOctaves) / count;
+            
+            for (int i = 0; i < count; i++)
+                modulationOctaves[(size_t) i] += lastModulation.cutoffOctaves + step * (i + 1);
+            
+            ladderProcessor.processModulated(channels.data(), numChannels, count, modulationOctaves.data(), output.resonance);
+            }
+        else {
+            ladderProcessor.processRamped(channels.data(), numChannels, count, output.cutoffOctaves, output.resonance);
+            }
+        
+        lastModulation = output;
+    }
+}
+
+bool LadderFilterAudioProcessor::isSidechainActive (const juce::AudioBuffer<float>& sidechain) const
+{
+    return sidechain.getNumChannels() > 0 && (sidechainDepthSmoother.isSmoothing() || sidechainDepthSmoother.getTargetValue() != 0.0f);
+}
+
+void LadderFilterAudioProcessor::fillSidechainOctaves (const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples)
+{
+    const auto sidechainChannels = sidechain.getNumChannels();
+    const auto sidechainGain = 1.0f / (float) sidechainChannels;
+    
+    //mono sum of the sidechain, times the depth in octaves
+    juce::FloatVectorOperations::copyWithMultiply(modulationOctaves.data(), sidechain.getReadPointer(0, startSample), sidechainGain, numSamples);
+    
+    for (int channel = 1; channel < sidechainChannels; channel++)
+        juce::FloatVectorOperations::addWithMultiply(modulationOctaves.data(), sidechain.getReadPointer(channel, startSample), sidechainGain, numSamples);
+    
+    if (sidechainDepthSmoother.isSmoothing()) {
+        for (int i = 0; i < numSamples; i++)
+            modulationOctaves[(size_t) i] *= sidechainDepthSmoother.getNextValue();
+        }
+    else {
+        juce::FloatVectorOperations::multiply(modulationOctaves.data(), sidechainDepthSmoother.getTargetValue(), numSamples);
+        }
+}
+
+void LadderFilterAudioProcessor::processModulatedLadder (juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), 2);
+    std::array<float*, 2> channels {};
+    
+    for (int offset = 0; offset < numSamples; offset += modulationChunkSize) {
+        const auto count = juce::jmin(modulationChunkSize, numSamples - offset);
+        const auto start = startSample + offset;
+        
+        fillSidechainOctaves(sidechain, start, count);
+        
+        for (int channel = 0; channel < numChannels; channel++)
+            channels[(size_t) channel] = buffer.getWritePointer(channel, start);
+        
+        ladderProcessor.processModulated(channels.data(), numChannels, count, modulationOctaves.data());
+    }
+}
+
+ModulationEngine::Settings LadderFilterAudioProcessor::getModulationSettings() const
+{
+    ModulationEngine::Settings modulationSettings;
+    modulationSettings.lfoRate = value(lfoRateId);
+    modulationSettings.lfoShape = (ModulationEngine::Shape) (int) value(lfoShapeId);
+    modulationSettings.lfoAmounts = { value(lfoCutoffId), value(lfoResonanceId), value(lfoDriveId) };
+    modulationSettings.attackMs = value(envAttackId);
+    modulationSettings.releaseMs = value(envReleaseId);
+    modulationSettings.envelopeAmounts = { value(envCutoffId), value(envResonanceId), value(envDriveId) };
+    modulationSettings.interval = 8 << (int) value(controlRateId);
+    return modulationSettings;
+}
+
+void LadderFilterAudioProcessor::processStereoSegment (juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const ChainSettings& settings)
+{
+    const auto mode = (LadderKernel::Mode) (int) value(filterModeId);
+    
+    //key tracking moves both sides by the same amount
+    const float keyTrack = value(keyTrackId);
+    const float sideCutoff = juce::jlimit(20.0f, 20000.0f, value(sideCutoffId) * std::exp2(keyTrack * midiControl.getKeyTrackOctaves()));
+    
+    stereoLadder.setSettings({ settings.drive, settings.cutoff, settings.resonance, settings.trim, mode },
+                             { value(sideDriveId), sideCutoff, value(sideResonanceId), value(sideTrimId), mode });
+    
+    stereoLadder.process(buffer, startSample, numSamples, stereoMode == 1 ? StereoLadder::Layout::midSide : StereoLadder::Layout::leftRight);
+}
+
+void LadderFilterAudioProcessor::updateBlockValues()
+{
+    for (size_t i = 0; i < blockValues.size(); i++)
+        blockValues[i] = rawValues[i]->load();
+    
+    //read as one snapshot at the block start, over the knobs' values
+    if (value(morphOnId) > 0.5f)
+        snapshots.morph((int) value(morphFromId), (int) value(morphToId), value(morphSliderId), blockValues);
+}
+
+float LadderFilterAudioProcessor::value(const char* parameterId) const
+{
+    const auto index = PresetFormat::indexOf(parameterId);
+    jassert(index >= 0);
+    return blockValues[(size_t) index];
+}
+
+int LadderFilterAudioProcessor::getNumBands() const
+{
+    return 1 + (int) value(bandsId);
+}
+
+void LadderFilterAudioProcessor::updateMultiband()
+{
+    multiband.setCrossovers({ value(crossover1Id), value(crossover2Id), value(crossover3Id) }, getNumBands());
+    
+    //the bands share the filter mode, the rest is their own
+    const auto mode = (LadderKernel::Mode) (int) value(filterModeId);
+    
+    for (int band = 0; band < MultibandLadder::maxBands; band++) {
+        const auto& ids = bandParameterIds[band];
+        multiband.setBand(band, { value(ids[0]), value(ids[1]), value(ids[2]), value(ids[3]), mode });
+    }
+}
+
+ResponseCurve::Settings LadderFilterAudioProcessor::getResponseSettings() const
+{
+    //read from the parameters, never from ladderProcessor, which belongs to the audio thread
+    return {
+        getSampleRate() > 0.0 ? getSampleRate() : 44100.0,
+        treeState.getRawParameterValue(cutoffSliderId)->load(),
+        treeState.getRawParameterValue(resoDelaySliderId)->load(),
+        treeState.getRawParameterValue(trimSliderId)->load(),
+        (ResponseCurve::Mode) (int) treeState.getRawParameterValue(filterModeId)->load()
+    };
+}
+
 float LadderFilterAudioProcessor::softClip(const float &input, const float &drive){
     
     //1.5f to account for drop in gain from the saturation initial state
@@ -212,21 +700,186 @@ juce::AudioProcessorEditor* LadderFilterAudioProcessor::createEditor()
 //==============================================================================
 void LadderFilterAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
+    applyPendingState();
+    
+    PresetFormat::Values values;
+    
+    for (int i = 0; i < PresetFormat::numParameters; i++)
+        values[(size_t) i] = treeState.getRawParameterValue(PresetFormat::parameterIds[i])->load();
+    
     juce::MemoryOutputStream stream(destData, false);
-    treeState.state.writeToStream (stream);
+    PresetFormat::write(values, stream);
+    snapshots.write(stream);
 }
 
 void LadderFilterAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    juce::ValueTree tree = juce::ValueTree::readFromData (data, size_t (sizeInBytes));
-    if (tree.isValid()) {
-        treeState.state = tree;
+    if (data == nullptr || sizeInBytes <= 0)
+        return;
+    
+    //Decoded and checked on the pool, so a session with many instances decodes them side by side
+    //while the host carries on. Applied by whichever comes first: prepareToPlay, getStateInformation
+    //or the message thread once the decode is done. Hosts that render straight after loading,
+    //offline or with no message loop running, still hear the restored state from the first block.
+    auto state = std::make_shared<DecodedState>();
+    
+    {
+        std::lock_guard<std::mutex> guard (pendingLock);
+        pendingState = state;
+    }
+    
+    //older sessions still decode, someone may be waiting on one, but only the newest is applied
+    backgroundJobs.submit([this, state, block = juce::MemoryBlock (data, size_t (sizeInBytes))] {
+        auto tree = validateState(decodeState(block));
+        
+        {
+            std::lock_guard<std::mutex> guard (state->lock);
+            state->tree = std::move(tree);
+            state->ready = true;
         }
+        
+        state->decoded.notify_all();
+        triggerAsyncUpdate();
+    });
+}
+
+void LadderFilterAudioProcessor::applyPendingState()
+{
+    std::shared_ptr<DecodedState> state;
+    
+    {
+        std::lock_guard<std::mutex> guard (pendingLock);
+        state = std::move(pendingState);
+    }
+    
+    if (state == nullptr)
+        return;
+    
+    juce::ValueTree tree;
+    
+    {
+        std::unique_lock<std::mutex> guard (state->lock);
+        state->decoded.wait(guard, [&state] { return state->ready; });
+        tree = state->tree;
+    }
+    
+    applyState(tree);
+}
+
+void LadderFilterAudioProcessor::handleAsyncUpdate()
+{
+    applyPendingState();
+}
+
+juce::ValueTree LadderFilterAudioProcessor::decodeState(const juce::MemoryBlock& data) const
+{
+    //any version, including the ValueTree sessions held before the binary format
+    auto values = getDefaultValues();
+    juce::MemoryInputStream stream (data, false);
+    
+    if (! PresetFormat::read(stream, values))
+        return {};
+    
+    //same shape as the APVTS state so replaceState can take it
+    juce::ValueTree tree (treeState.state.getType());
+    
+    for (int i = 0; i < PresetFormat::numParameters; i++)
+        tree.appendChild(juce::ValueTree ("PARAM", {{ "id", PresetFormat::parameterIds[i] }, { "value", values[(size_t) i] }}), nullptr);
+    
+    //snapshots follow the preset in sessions saved since they were added
+    auto snapshotTree = SnapshotMorph::read(stream);
+    
+    if (snapshotTree.isValid())
+        tree.appendChild(snapshotTree, nullptr);
+    
+    return tree;
+}
+
+PresetFormat::Values LadderFilterAudioProcessor::getDefaultValues() const
+{
+    PresetFormat::Values values;
+    
+    for (int i = 0; i < PresetFormat::numParameters; i++) {
+        auto* parameter = treeState.getParameter(PresetFormat::parameterIds[i]);
+        values[(size_t) i] = parameter->convertFrom0to1(parameter->getDefaultValue());
+    }
+    
+    return values;
+}
+
+Snapshot LadderFilterAudioProcessor::getCurrentSnapshot() const
+{
+    Snapshot snapshot;
+    
+    for (size_t i = 0; i < snapshot.size(); i++)
+        snapshot[i] = rawValues[i]->load();
+    
+    return snapshot;
+}
+
+juce::ValueTree LadderFilterAudioProcessor::validateState(juce::ValueTree tree) const
+{
+    if (! tree.isValid() || ! tree.hasType(treeState.state.getType()))
+        return {};
+    
+    for (auto child : tree) {
+        auto* parameter = treeState.getParameter(child.getProperty("id").toString());
+        
+        if (parameter == nullptr || ! child.hasProperty("value"))
+            continue;
+        
+        //drop values that aren't numbers so the parameter keeps its default, clamp the rest
+        auto value = (double) child.getProperty("value");
+        auto range = parameter->getNormalisableRange();
+        
+        if (std::isfinite(value))
+            child.setProperty("value", juce::jlimit((double) range.start, (double) range.end, value), nullptr);
+        else
+            child.removeProperty("value", nullptr);
+    }
+    
+    return tree;
+}
+
+void LadderFilterAudioProcessor::applyState(juce::ValueTree tree)
+{
+    if (! tree.isValid())
+        return;
+    
+    auto snapshotTree = tree.getChildWithName(SnapshotMorph::getTreeType());
+    
+    if (snapshotTree.isValid()) {
+        //each value is held to its parameter's range, what a slot doesn't hold comes from the session
+        Snapshot lowest, highest, session = getDefaultValues();
+        
+        for (int i = 0; i < PresetFormat::numParameters; i++) {
+            const auto range = treeState.getParameter(PresetFormat::parameterIds[i])->getNormalisableRange();
+            lowest[(size_t) i] = range.start;
+            highest[(size_t) i] = range.end;
+        }
+        
+        for (auto child : tree) {
+            const auto index = PresetFormat::indexOf(child.getProperty("id").toString().toRawUTF8());
+            
+            if (index >= 0 && child.hasProperty("value"))
+                session[(size_t) index] = (float) child.getProperty("value");
+        }
+        
+        snapshots.restore(snapshotTree, lowest, highest, session);
+        }
+    
+    //every parameter in one replaceState, the audio thread ramps to the new values
+    treeState.replaceState(tree);
 }
 
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
+    //the rack is a separate plugin (LadderFilterRack.jucer), never this one under another processor
+   #if LADDER_FILTER_RACK
+    return new LadderRackAudioProcessor();
+   #else
     return new LadderFilterAudioProcessor();
+   #endif
 }
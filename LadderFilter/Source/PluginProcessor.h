@@ -9,6 +9,18 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "AnalyzerFifo.h"
+#include "ResponseCurve.h"
+#include "SharedWorkerPool.h"
+#include "../../LadderCore/Source/SharedTables.h"
+#include "SnapshotMorph.h"
+#include "PresetBank.h"
+#include "MidiControl.h"
+#include "../../LadderCore/Source/LadderKernel.h"
+#include "../../LadderCore/Source/PrepareCache.h"
+#include "ModulationEngine.h"
+#include "MultibandLadder.h"
+#include "StereoLadder.h"
 
 #define driveSliderId "drive"
 #define driveSliderName "Drive"
@@ -22,10 +34,110 @@
 #define trimSliderId "trim"
 #define trimSliderName "Trim"
 
+#define morphOnId "morphOn"
+#define morphOnName "Morph On"
+
+#define morphSliderId "morph"
+#define morphSliderName "Morph"
+
+#define morphFromId "morphFrom"
+#define morphFromName "Morph From"
+
+#define morphToId "morphTo"
+#define morphToName "Morph To"
+
+#define keyTrackId "keyTrack"
+#define keyTrackName "Key Track"
+
+#define sidechainDepthId "sidechainDepth"
+#define sidechainDepthName "Sidechain Depth"
+
+#define lfoRateId "lfoRate"
+#define lfoRateName "LFO Rate"
+
+#define lfoShapeId "lfoShape"
+#define lfoShapeName "LFO Shape"
+
+#define lfoCutoffId "lfoCutoff"
+#define lfoCutoffName "LFO > Cutoff"
+
+#define lfoResonanceId "lfoResonance"
+#define lfoResonanceName "LFO > Resonance"
+
+#define lfoDriveId "lfoDrive"
+#define lfoDriveName "LFO > Drive"
+
+#define envAttackId "envAttack"
+#define envAttackName "Envelope Attack"
+
+#define envReleaseId "envRelease"
+#define envReleaseName "Envelope Release"
+
+#define envCutoffId "envCutoff"
+#define envCutoffName "Envelope > Cutoff"
+
+#define envResonanceId "envResonance"
+#define envResonanceName "Envelope > Resonance"
+
+#define envDriveId "envDrive"
+#define envDriveName "Envelope > Drive"
+
+#define controlRateId "controlRate"
+#define controlRateName "Control Rate"
+
+#define filterModeId "mode"
+#define filterModeName "Mode"
+
+#define bandsId "bands"
+#define bandsName "Bands"
+
+#define crossover1Id "crossover1"
+#define crossover1Name "Crossover 1"
+
+#define crossover2Id "crossover2"
+#define crossover2Name "Crossover 2"
+
+#define crossover3Id "crossover3"
+#define crossover3Name "Crossover 3"
+
+//per-band controls, named "Band N Drive" and so on in the layout
+#define band1DriveId "band1Drive"
+#define band1CutoffId "band1Cutoff"
+#define band1ResonanceId "band1Resonance"
+#define band1TrimId "band1Trim"
+#define band2DriveId "band2Drive"
+#define band2CutoffId "band2Cutoff"
+#define band2ResonanceId "band2Resonance"
+#define band2TrimId "band2Trim"
+#define band3DriveId "band3Drive"
+#define band3CutoffId "band3Cutoff"
+#define band3ResonanceId "band3Resonance"
+#define band3TrimId "band3Trim"
+#define band4DriveId "band4Drive"
+#define band4CutoffId "band4Cutoff"
+#define band4ResonanceId "band4Resonance"
+#define band4TrimId "band4Trim"
+
+#define stereoModeId "stereoMode"
+#define stereoModeName "Stereo Mode"
+
+#define sideDriveId "sideDrive"
+#define sideDriveName "Side/Right Drive"
+
+#define sideCutoffId "sideCutoff"
+#define sideCutoffName "Side/Right Cutoff"
+
+#define sideResonanceId "sideResonance"
+#define sideResonanceName "Side/Right Resonance"
+
+#define sideTrimId "sideTrim"
+#define sideTrimName "Side/Right Trim"
+
 //==============================================================================
 /**
 */
-class LadderFilterAudioProcessor  : public juce::AudioProcessor
+class LadderFilterAudioProcessor  : public juce::AudioProcessor,
+                                    private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -65,17 +177,133 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     
+    //exact saturation curve, processBlock uses the shared atan table with the same gains
     float softClip(const float &input, const float &drive);
     
     juce::AudioProcessorValueTreeState treeState;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    
+    //output samples for the editor's spectrum analyzer
+    AnalyzerFifo analyzerFifo;
+    
+    //shared by all open editors, message thread only
+    ResponseCurve responseCurve;
+    ResponseCurve::Settings getResponseSettings() const;
+    
+    //A/B/C/D snapshots of every parameter, stored from the editor and morphed on the audio thread
+    SnapshotMorph snapshots;
+    Snapshot getCurrentSnapshot() const;
+    
+    //what releaseResources gives back, freeBuffers unless set: see releaseResources for what that covers.
+    //Message thread, not while prepareToPlay runs.
+    void setReleasePolicy(PrepareCache::ReleasePolicy policy) { releasePolicy = policy; }
 
 private:
     
+    //checks a decoded tree against the parameter layout, returns an invalid tree if it can't be used
+    juce::ValueTree validateState(juce::ValueTree tree) const;
+    juce::ValueTree decodeState(const juce::MemoryBlock& data) const;
+    PresetFormat::Values getDefaultValues() const;
+    void applyState(juce::ValueTree tree);
+    
+    //a restored session, decoded and checked on the pool
+    struct DecodedState
+    {
+        std::mutex lock;
+        std::condition_variable decoded;
+        bool ready = false;
+        juce::ValueTree tree;
+    };
+    
+    //Waits for the newest restored session to be decoded and applies it, once. Called by
+    //prepareToPlay and getStateInformation, so hosts that render or save straight after a
+    //load get the loaded state, and from the message thread when the decode finishes.
+    void applyPendingState();
+    void handleAsyncUpdate() override;
+    
+    std::mutex pendingLock;
+    std::shared_ptr<DecodedState> pendingState;
+    
+    //runs the drive, ladder and trim over part of the buffer with fixed settings, chunkSize samples at a time
+    void processSegment(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples, const ChainSettings& settings);
+    void processChunk(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples, const ChainSettings& settings);
+    
+    //drive and ladder one control interval at a time, with the LFO and envelope follower moving them
+    void processModulatedSegment(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples, float drive);
+    
+    //ladder pass with the cutoff following the sidechain, sample by sample
+    void processModulatedLadder(juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples);
+    bool isSidechainActive(const juce::AudioBuffer<float>& sidechain) const;
+    void fillSidechainOctaves(const juce::AudioBuffer<float>& sidechain, int startSample, int numSamples);
+    
+    ModulationEngine::Settings getModulationSettings() const;
+    
+    //mid/side or left/right, the main settings on one side and the side/right controls on the other
+    void processStereoSegment(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, const ChainSettings& settings);
+    
+    //The parameters the audio thread plays: the live values, or the morph over them while it's on.
+    //Filled at the start of each block and in prepareToPlay, everything from processBlock on reads
+    //value() rather than the parameters, so a morph moves every parameter it covers at once.
+    void updateBlockValues();
+    float value(const char* parameterId) const;
+    std::array<std::atomic<float>*, PresetFormat::numParameters> rawValues;
+    Snapshot blockValues {};
+    
+    //band count from the bands parameter, 1 is the plain single chain
+    int getNumBands() const;
+    void updateMultiband();
+    
+    //decoded once per process, program changes just copy values out of it
+    std::shared_ptr<const PresetBank> presetBank;
+    std::atomic<int> currentProgram { 0 };
+    
+    //parameter jumps, e.g. from a state restore, are ramped over this time
+    static constexpr double rampSeconds = 0.05;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> inputGainSmoother, outputGainSmoother;
+    
     const float piDivisor = 2 / M_PI;
-    juce::dsp::LadderFilter<float> ladderProcessor;
+    std::shared_ptr<const SaturationTable> saturation;
+    
+    //hosts switching projects or devices come back to the same few configurations
+    PrepareCache prepareCache;
+    PrepareCache::ReleasePolicy releasePolicy = PrepareCache::ReleasePolicy::freeBuffers;
+    
+    //the static drive loop runs on the best instruction set, picked in prepareToPlay
+    const DspKernels* kernels = &CpuDispatch::getKernels();
+    LadderKernel ladderProcessor;
     juce::dsp::Gain<float> trimProcessor;
     
+    //sidechain audio as octaves of cutoff offset, filled a chunk at a time
+    static constexpr int modulationChunkSize = 256;
+    std::array<float, modulationChunkSize> modulationOctaves {};
+    juce::SmoothedValue<float> sidechainDepthSmoother;
+    
+    //LFO and envelope follower, and where they had got to at the end of the last interval
+    ModulationEngine modulation;
+    ModulationEngine::Output lastModulation;
+    bool wasModulating = false;
+    
+    //2 to 4 bands, each with its own drive, ladder and trim, all run side by side
+    MultibandLadder multiband;
+    bool multibandActive = false;
+    
+    //mid/side or left/right with their own settings, 0 while both channels share the single chain
+    StereoLadder stereoLadder;
+    int stereoMode = 0;
+    
+    //Hosts may send bigger blocks than prepareToPlay was given, so everything is prepared for
+    //chunkSize and processBlock never hands it more. Small promised sizes are rounded up to
+    //minChunkSize, the chain handles any length and the per-chunk setup isn't free.
+    static constexpr int minChunkSize = 64;
+    int chunkSize = minChunkSize;
+    
+    //the block is split at every MIDI event, so each change lands on its own sample
+    MidiControl midiControl;
+    ChainSettings lastSettings;
+    
+    //decodes restored sessions; stopped in the destructor, before any member it could touch is destroyed
+    SharedWorkerPool::Client backgroundJobs;
+    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LadderFilterAudioProcessor)
 };
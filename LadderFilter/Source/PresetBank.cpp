@@ -0,0 +1,249 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+#include "PluginProcessor.h"
+
+const char* const PresetFormat::parameterIds[] = {
+    driveSliderId, cutoffSliderId, resoDelaySliderId, trimSliderId,
+    morphOnId, morphSliderId, morphFromId, morphToId,
+    keyTrackId, sidechainDepthId,
+    lfoRateId, lfoShapeId, lfoCutoffId, lfoResonanceId, lfoDriveId,
+    envAttackId, envReleaseId, envCutoffId, envResonanceId, envDriveId,
+    controlRateId, filterModeId,
+    bandsId, crossover1Id, crossover2Id, crossover3Id,
+    band1DriveId, band1CutoffId, band1ResonanceId, band1TrimId,
+    band2DriveId, band2CutoffId, band2ResonanceId, band2TrimId,
+    band3DriveId, band3CutoffId, band3ResonanceId, band3TrimId,
+    band4DriveId, band4CutoffId, band4ResonanceId, band4TrimId,
+    stereoModeId, sideDriveId, sideCutoffId, sideResonanceId, sideTrimId
+};
+
+int PresetFormat::indexOf(const char* parameterId)
+{
+    for (int i = 0; i < numParameters; i++)
+        if (std::strcmp(parameterIds[i], parameterId) == 0)
+            return i;
+    
+    return -1;
+}
+
+namespace
+{
+    const char presetMagic[] = { 'L', 'F', 'P', 'R' };
+    const char bankMagic[] = { 'L', 'F', 'B', 'K' };
+    
+    bool readMagic(juce::InputStream& stream, const char (&magic)[4])
+    {
+        char header[4];
+        return stream.read(header, 4) == 4 && std::memcmp(header, magic, 4) == 0;
+    }
+    
+    //One rule for presets and banks: version 0 is the ValueTree, never written with a header
+    bool isReadableVersion(int version)
+    {
+        return version >= 1;
+    }
+    
+    //version 0: the APVTS state, one PARAM child per parameter, matched by id
+    bool readValueTree(juce::InputStream& stream, PresetFormat::Values& values)
+    {
+        const auto tree = juce::ValueTree::readFromStream(stream);
+        
+        if (! tree.isValid())
+            return false;
+        
+        for (const auto& child : tree) {
+            const auto id = child.getProperty("id").toString();
+            const auto found = std::find_if(std::begin(PresetFormat::parameterIds), std::end(PresetFormat::parameterIds),
+                                            [&id] (const char* parameterId) { return id == parameterId; });
+            const auto value = (float) (double) child.getProperty("value", std::numeric_limits<double>::quiet_NaN());
+            
+            if (found != std::end(PresetFormat::parameterIds) && std::isfinite(value))
+                values[(size_t) (found - std::begin(PresetFormat::parameterIds))] = value;
+            }
+        
+        PresetFormat::migrate(values, 0);
+        return true;
+    }
+}
+
+//==============================================================================
+bool PresetFormat::isPreset(const void* data, size_t size)
+{
+    return data != nullptr && size >= 8 && std::memcmp(data, presetMagic, 4) == 0;
+}
+
+bool PresetFormat::read(const void* data, size_t size, Values& values)
+{
+    juce::MemoryInputStream stream (data, size, false);
+    return read(stream, values);
+}
+
+bool PresetFormat::read(juce::InputStream& stream, Values& values)
+{
+    const auto start = stream.getPosition();
+    
+    //sessions saved before this format hold a ValueTree
+    if (! readMagic(stream, presetMagic))
+        return stream.setPosition(start) && readValueTree(stream, values);
+    
+    const int version = (juce::uint16) stream.readShort();
+    const int count = (juce::uint16) stream.readShort();
+    
+    if (! isReadableVersion(version) || stream.getNumBytesRemaining() < count * 4)
+        return false;
+    
+    //read into a copy, so a preset that turns out to be bad leaves the caller's values alone
+    auto stored = values;
+    
+    //fewer values than we know keep their defaults, values past ours are read and dropped
+    for (int i = 0; i < count; i++) {
+        auto value = stream.readFloat();
+        
+        if (i < numParameters && std::isfinite(value))
+            stored[(size_t) i] = value;
+        }
+    
+    //a newer version's values are already what we'd migrate them to, as far as we know them
+    if (version < currentVersion)
+        migrate(stored, version);
+    
+    values = stored;
+    return true;
+}
+
+void PresetFormat::migrate(Values& values, int fromVersion)
+{
+    //Each version bump adds its step here, bringing the version before it up to the new meaning:
+    //    if (fromVersion < 2) { ...version 1 to 2... }
+    //Version 0 needs none, the ValueTree held what version 1 holds, by id instead of by position.
+    juce::ignoreUnused (values, fromVersion);
+}
+
+//==============================================================================
+std::shared_ptr<const PresetBank> PresetBank::getInstance(const PresetFormat::Values& defaults)
+{
+    static const std::shared_ptr<const PresetBank> bank = [&defaults] {
+        if (auto user = load(getUserBankFile(), defaults))
+            if (user->size() > 0)
+                return std::shared_ptr<const PresetBank> (std::move(user));
+        
+        return std::shared_ptr<const PresetBank> (createFactoryBank(defaults));
+    }();
+    
+    return bank;
+}
+
+juce::File PresetBank::getUserBankFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+            .getChildFile("Viator DSP")
+            .getChildFile("Ladder Filter")
+            .getChildFile("Presets.lfbank");
+}
+
+std::unique_ptr<PresetBank> PresetBank::load(const juce::File& file, const PresetFormat::Values& defaults)
+{
+    if (! file.existsAsFile())
+        return nullptr;
+    
+    auto bank = std::make_unique<PresetBank>();
+    juce::MemoryMappedFile mapped (file, juce::MemoryMappedFile::readOnly);
+    
+    if (mapped.getData() != nullptr) {
+        juce::MemoryInputStream stream (mapped.getData(), mapped.getSize(), false);
+        return bank->read(stream, defaults) ? std::move(bank) : nullptr;
+        }
+    
+    //mapping can fail on some file systems, fall back to a plain read
+    juce::FileInputStream stream (file);
+    
+    if (stream.openedOk() && bank->read(stream, defaults))
+        return bank;
+    
+    return nullptr;
+}
+
+bool PresetBank::read(juce::InputStream& stream, const PresetFormat::Values& defaults)
+{
+    if (! readMagic(stream, bankMagic))
+        return false;
+    
+    const int version = (juce::uint16) stream.readShort();
+    const int count = (juce::uint16) stream.readShort();
+    
+    if (! isReadableVersion(version))
+        return false;
+    
+    //anything a newer bank has after its presets is left unread
+    presets.reserve((size_t) count);
+    
+    for (int i = 0; i < count; i++) {
+        const int nameLength = (juce::uint8) stream.readByte();
+        juce::MemoryBlock name;
+        
+        if ((int) stream.readIntoMemoryBlock(name, nameLength) != nameLength)
+            return false;
+        
+        Preset preset { name.toString(), defaults };
+        
+        if (! PresetFormat::read(stream, preset.values))
+            return false;
+        
+        presets.push_back(std::move(preset));
+        }
+    
+    return true;
+}
+
+bool PresetBank::save(const juce::File& file) const
+{
+    juce::MemoryOutputStream stream;
+    stream.write(bankMagic, 4);
+    stream.writeShort((short) currentVersion);
+    stream.writeShort((short) presets.size());
+    
+    for (auto& preset : presets) {
+        auto name = preset.name.toUTF8();
+        auto nameLength = juce::jmin((int) name.sizeInBytes() - 1, 255);
+        
+        stream.writeByte((char) nameLength);
+        stream.write(name.getAddress(), (size_t) nameLength);
+        PresetFormat::write(preset.values, stream);
+        }
+    
+    return file.getParentDirectory().createDirectory() && file.replaceWithData(stream.getData(), stream.getDataSize());
+}
+
+std::unique_ptr<PresetBank> PresetBank::createFactoryBank(const PresetFormat::Values& defaults)
+{
+    struct FactoryPreset { const char* name; float drive, cutoff, resonance, trim; };
+    
+    static const FactoryPreset factoryPresets[] = {
+        { "Init",         0.0f,   750.0f, 0.5f,   0.0f },
+        { "Warm Drive",   4.0f,  2500.0f, 0.3f,  -3.0f },
+        { "Dark Mud",     2.0f,   300.0f, 0.2f,   2.0f },
+        { "Squelch",      6.0f,   900.0f, 0.9f,  -6.0f },
+        { "Air Cut",      0.0f,  8000.0f, 0.1f,   0.0f },
+        { "Screamer",    10.0f,  1200.0f, 0.75f, -9.0f }
+    };
+    
+    auto bank = std::make_unique<PresetBank>();
+    
+    for (auto& factoryPreset : factoryPresets) {
+        Preset preset { factoryPreset.name, defaults };
+        preset.values[0] = factoryPreset.drive;
+        preset.values[1] = factoryPreset.cutoff;
+        preset.values[2] = factoryPreset.resonance;
+        preset.values[3] = factoryPreset.trim;
+        bank->presets.push_back(std::move(preset));
+        }
+    
+    return bank;
+}
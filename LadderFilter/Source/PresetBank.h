@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+
+    Binary preset format and the program bank.
+
+    A preset is "LFPR", a version, a value count and that many little-endian
+    floats in parameterIds order.
+    Parameters are only ever appended and appending doesn't bump the version,
+    so whatever the version:
+    - a preset with fewer values than we know leaves the rest at their defaults
+    - a preset with more values than we know has the extra ones read and dropped
+    - a value that isn't finite keeps its default
+    Anything that changes the meaning of an existing value bumps the version,
+    and the same change adds a step to PresetFormat::migrate that brings the
+    version before it up to the new meaning; older data goes through every
+    step from its version on. Version 0 is the ValueTree the plugin saved
+    before this format, read by parameter id. Newer versions are read as far
+    as we know them, the append-only list means our values are where we
+    expect, and whatever a newer build changed the meaning of is its own
+    business to migrate when it reads our presets.
+
+    A bank is "LFBK", a version, a preset count and then, per preset, a
+    one-byte name length, the UTF-8 name and a preset as above. A bank bump
+    only adds things after the last preset, so newer banks are read the
+    same way. The bank is read once per process, memory-mapped where the OS
+    allows, and every preset is decoded up front so switching programs is a
+    lookup.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace PresetFormat
+{
+    //append only - the position of a parameter is its place in every preset ever written
+    static constexpr int numParameters = 47;
+    extern const char* const parameterIds[numParameters];
+
+    static constexpr int currentVersion = 1;
+
+    using Values = std::array<float, numParameters>;
+
+    //position of a parameter in parameterIds, -1 if it isn't there
+    int indexOf(const char* parameterId);
+
+    //Values must hold the defaults on the way in, only the stored ones are overwritten. Reads a
+    //preset of any version, or the ValueTree sessions held before, and migrates it to ours.
+    bool read(juce::InputStream& stream, Values& values);
+    bool read(const void* data, size_t size, Values& values);
+    void write(const Values& values, juce::OutputStream& stream);
+
+    //brings values stored by fromVersion up to currentVersion, one version at a time
+    void migrate(Values& values, int fromVersion);
+
+    bool isPreset(const void* data, size_t size);
+}
+
+class PresetBank
+{
+public:
+    struct Preset
+    {
+        juce::String name;
+        PresetFormat::Values values;
+    };
+
+    //The user bank if there is one, otherwise the factory presets. Built once per process,
+    //values a preset doesn't store come from defaults.
+    static std::shared_ptr<const PresetBank> getInstance(const PresetFormat::Values& defaults);
+
+    //Where a user bank is looked for
+    static juce::File getUserBankFile();
+
+    static std::unique_ptr<PresetBank> load(const juce::File& file, const PresetFormat::Values& defaults);
+    static std::unique_ptr<PresetBank> createFactoryBank(const PresetFormat::Values& defaults);
+    bool save(const juce::File& file) const;
+
+    int size() const { return (int) presets.size(); }
+    const Preset& operator[](int index) const { return presets[(size_t) index]; }
+
+private:
+
+    static constexpr int currentVersion = 1;
+
+    bool read(juce::InputStream& stream, const PresetFormat::Values& defaults);
+
+    std::vector<Preset> presets;
+};
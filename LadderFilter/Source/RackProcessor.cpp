@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    RackProcessor.cpp
+
+  ==============================================================================
+*/
+
+#include "RackProcessor.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    //in the order chainParameters holds them
+    const char* const chainParameterIds[] = { driveSliderId, cutoffSliderId, resoDelaySliderId, trimSliderId, filterModeId };
+
+    juce::AudioProcessor::BusesProperties getRackBuses()
+    {
+        juce::AudioProcessor::BusesProperties buses;
+
+        //only the first chain is on by default, the host enables the rest
+        for (int chain = 0; chain < LadderRackAudioProcessor::numChains; chain++) {
+            const auto name = "Chain " + juce::String (chain + 1);
+            buses.addBus(true, name, juce::AudioChannelSet::stereo(), chain == 0);
+            buses.addBus(false, name, juce::AudioChannelSet::stereo(), chain == 0);
+        }
+
+        return buses;
+    }
+}
+
+//==============================================================================
+LadderRackAudioProcessor::LadderRackAudioProcessor()
+     : AudioProcessor (getRackBuses()),
+treeState (*this, nullptr, "PARAMETER", createParameterLayout())
+{
+    for (int chain = 0; chain < numChains; chain++)
+        for (size_t i = 0; i < chainParameters[(size_t) chain].size(); i++)
+            chainParameters[(size_t) chain][i] = treeState.getRawParameterValue(getChainParameterId(chain, chainParameterIds[i]));
+}
+
+LadderRackAudioProcessor::~LadderRackAudioProcessor()
+{
+}
+
+juce::String LadderRackAudioProcessor::getChainParameterId(int chain, const char* parameterId)
+{
+    return "chain" + juce::String (chain + 1) + "_" + parameterId;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout LadderRackAudioProcessor::createParameterLayout()
+{
+    std::vector <std::unique_ptr<juce::RangedAudioParameter>> params;
+    params.reserve(numChains * 5);
+
+    //each chain has the single plugin's controls and ranges
+    for (int chain = 0; chain < numChains; chain++) {
+        const auto name = "Chain " + juce::String (chain + 1) + " ";
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getChainParameterId(chain, driveSliderId), name + driveSliderName, 0.0, 10.0, 0.0));
+        params.push_back(std::make_unique<juce::AudioParameterInt>(getChainParameterId(chain, cutoffSliderId), name + cutoffSliderName, 20, 20000, 750));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getChainParameterId(chain, resoDelaySliderId), name + resoDelaySliderName, 0.0, 1.0, 0.5));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getChainParameterId(chain, trimSliderId), name + trimSliderName, -36.0, 36.0, 0.0));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getChainParameterId(chain, filterModeId), name + filterModeName,
+                                                                      juce::StringArray { "LP 12", "HP 12", "BP 12", "LP 24", "HP 24", "BP 24" }, 0));
+    }
+
+    return { params.begin(), params.end() };
+}
+
+//==============================================================================
+const juce::String LadderRackAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool LadderRackAudioProcessor::acceptsMidi() const
+{
+    return false;
+}
+
+bool LadderRackAudioProcessor::producesMidi() const
+{
+    return false;
+}
+
+bool LadderRackAudioProcessor::isMidiEffect() const
+{
+    return false;
+}
+
+double LadderRackAudioProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+int LadderRackAudioProcessor::getNumPrograms()
+{
+    return 1;
+}
+
+int LadderRackAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void LadderRackAudioProcessor::setCurrentProgram (int index)
+{
+}
+
+const juce::String LadderRackAudioProcessor::getProgramName (int index)
+{
+    return {};
+}
+
+void LadderRackAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void LadderRackAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    lanes.prepare(sampleRate);
+    frames.fill(0.0f);
+}
+
+void LadderRackAudioProcessor::releaseResources()
+{
+}
+
+bool LadderRackAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+    //every chain is processed in place, so its output has to match its input
+    for (int chain = 0; chain < numChains; chain++) {
+        const auto input = layouts.getChannelSet(true, chain);
+
+        if (input != layouts.getChannelSet(false, chain))
+            return false;
+
+        if (! input.isDisabled()
+         && input != juce::AudioChannelSet::mono()
+         && input != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
+    return true;
+}
+
+void LadderRackAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    //disabled buses and missing channels keep a null pointer, their lanes run on silence
+    std::array<float*, Lanes::lanes> channels {};
+
+    for (int chain = 0; chain < numChains; chain++) {
+        const auto& parameters = chainParameters[(size_t) chain];
+        Lanes::Settings settings { parameters[0]->load(), parameters[1]->load(), parameters[2]->load(), parameters[3]->load(),
+                                   (LadderKernel::Mode) (int) parameters[4]->load() };
+
+        for (int channel = 0; channel < maxChannels; channel++)
+            lanes.setLane(getLane(chain, channel), settings);
+
+        auto bus = getBusBuffer(buffer, false, chain);
+
+        for (int channel = 0; channel < juce::jmin(bus.getNumChannels(), maxChannels); channel++)
+            channels[(size_t) getLane(chain, channel)] = bus.getWritePointer(channel);
+    }
+
+    const auto numSamples = buffer.getNumSamples();
+
+    for (int offset = 0; offset < numSamples; offset += chunkSize) {
+        const auto count = juce::jmin(chunkSize, numSamples - offset);
+
+        for (size_t lane = 0; lane < (size_t) Lanes::lanes; lane++) {
+            const auto* input = channels[lane];
+
+            for (int i = 0; i < count; i++)
+                frames[(size_t) i * Lanes::lanes + lane] = input != nullptr ? input[offset + i] : 0.0f;
+        }
+
+        lanes.process(frames.data(), count);
+
+        for (size_t lane = 0; lane < (size_t) Lanes::lanes; lane++) {
+            if (auto* output = channels[lane])
+                for (int i = 0; i < count; i++)
+                    output[offset + i] = frames[(size_t) i * Lanes::lanes + lane];
+        }
+    }
+}
+
+//==============================================================================
+bool LadderRackAudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* LadderRackAudioProcessor::createEditor()
+{
+    return new juce::GenericAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+void LadderRackAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    juce::MemoryOutputStream stream(destData, false);
+    treeState.copyState().writeToStream(stream);
+}
+
+void LadderRackAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    auto tree = juce::ValueTree::readFromData(data, size_t (sizeInBytes));
+
+    if (tree.isValid() && tree.hasType(treeState.state.getType()))
+        treeState.replaceState(tree);
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    RackProcessor.h
+
+    Rack variant of the plugin: numChains independent drive -> ladder -> trim
+    chains, each on its own stereo bus pair, in one instance. Every channel of
+    every chain is a lane of one LadderLanes, laid out channel by channel so
+    each SIMD instruction steps the same channel of four chains. Built in
+    place of LadderFilterAudioProcessor when LADDER_FILTER_RACK is set to 1,
+    which only LadderFilterRack/LadderFilterRack.jucer does: its buses and
+    parameters differ from the single plugin's, so it ships as its own
+    plugin with its own name, plugin code and bundle id.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../LadderCore/Source/LadderLanes.h"
+
+class LadderRackAudioProcessor  : public juce::AudioProcessor
+{
+public:
+    static constexpr int numChains = 8;
+    static constexpr int maxChannels = 2;
+
+    using Lanes = LadderLanes<numChains * maxChannels>;
+
+    //==============================================================================
+    LadderRackAudioProcessor();
+    ~LadderRackAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    //e.g. "chain3_cutoff", the single plugin's ids with the chain in front
+    static juce::String getChainParameterId(int chain, const char* parameterId);
+
+    juce::AudioProcessorValueTreeState treeState;
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+private:
+
+    //drive, cutoff, resonance, trim and mode of every chain, looked up once
+    std::array<std::array<std::atomic<float>*, 5>, numChains> chainParameters {};
+
+    //lane of a chain's channel, the same channel of every chain sits side by side
+    static int getLane(int chain, int channel) noexcept { return channel * numChains + chain; }
+
+    //frames are gathered from the buses and scattered back this many at a time
+    static constexpr int chunkSize = 64;
+
+    Lanes lanes;
+    std::array<float, chunkSize * Lanes::lanes> frames {};
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LadderRackAudioProcessor)
+};
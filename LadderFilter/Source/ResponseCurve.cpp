@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    ResponseCurve.cpp
+
+  ==============================================================================
+*/
+
+#include "ResponseCurve.h"
+
+namespace
+{
+    //the kernel's input and feedback gains at the drive of 1 the processor uses
+    const double inputGain = 0.6103 + 0.3903;
+}
+
+ResponseCurve::ResponseCurve()
+{
+    unitDelays.resize(numPoints);
+    stageResponses.resize(numPoints);
+    filterMagnitudes.resize(numPoints, 0.0f);
+    magnitudes.resize(numPoints, 0.0f);
+}
+
+double ResponseCurve::getFrequency(int index)
+{
+    return minFrequency * std::pow(maxFrequency / minFrequency, index / double (numPoints - 1));
+}
+
+const std::vector<float>& ResponseCurve::update(const Settings& settings)
+{
+    if (settings.sampleRate <= 0.0)
+        return magnitudes;
+    
+    //each stage forces the ones after it
+    const bool sampleRateChanged = settings.sampleRate != current.sampleRate;
+    const bool cutoffChanged = sampleRateChanged || settings.cutoff != current.cutoff;
+    const bool filterChanged = cutoffChanged || settings.resonance != current.resonance || settings.mode != current.mode;
+    const bool outputChanged = filterChanged || settings.trimDecibels != current.trimDecibels;
+    
+    current = settings;
+    
+    if (sampleRateChanged)
+        updateUnitDelays();
+    
+    if (cutoffChanged)
+        updateStageResponses();
+    
+    if (filterChanged)
+        updateFilterMagnitudes();
+    
+    if (outputChanged)
+        updateOutput();
+    
+    return magnitudes;
+}
+
+void ResponseCurve::updateUnitDelays()
+{
+    for (int i = 0; i < numPoints; i++) {
+        auto omega = juce::MathConstants<double>::twoPi * getFrequency(i) / current.sampleRate;
+        unitDelays[i] = std::polar(1.0, -omega);
+        }
+}
+
+void ResponseCurve::updateStageResponses()
+{
+    //one pole of the ladder: (b0 + b1 z^-1) / (1 - a1 z^-1)
+    const auto a1 = std::exp(-juce::MathConstants<double>::twoPi * current.cutoff / current.sampleRate);
+    const auto g = 1.0 - a1;
+    const auto b0 = g * 0.76923076923;
+    const auto b1 = g * 0.23076923076;
+    
+    for (int i = 0; i < numPoints; i++)
+        stageResponses[i] = (b0 + b1 * unitDelays[i]) / (1.0 - a1 * unitDelays[i]);
+}
+
+void ResponseCurve::updateFilterMagnitudes()
+{
+    const auto mix = LadderKernel::getTapMix(current.mode);
+    const auto k = 4.0 * juce::jmap((double) current.resonance, 0.1, 1.0);
+    
+    for (int i = 0; i < numPoints; i++) {
+        const auto h = stageResponses[i];
+        
+        //the first tap sees the input minus the delayed, compensated fourth stage output
+        const auto firstTap = inputGain * (1.0 + k * mix.compensation) / (1.0 + k * inputGain * unitDelays[i] * h * h * h * h);
+        
+        std::complex<double> output = 0.0, tap = firstTap;
+        
+        for (auto weight : mix.taps) {
+            output += (double) weight * tap;
+            tap *= h;
+            }
+        
+        filterMagnitudes[i] = (float) juce::Decibels::gainToDecibels(std::abs(output), -120.0);
+        }
+}
+
+void ResponseCurve::updateOutput()
+{
+    for (int i = 0; i < numPoints; i++)
+        magnitudes[i] = filterMagnitudes[i] + current.trimDecibels;
+    
+    version++;
+}
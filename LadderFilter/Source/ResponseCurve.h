@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    ResponseCurve.h
+
+    Magnitude response of the ladder, computed from the linearised filter
+    model rather than by probing the running filter. One instance lives in
+    the processor and is shared by every editor, and each stage of the
+    calculation is only redone when the inputs it depends on change.
+    Message thread only.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include "../../LadderCore/Source/LadderKernel.h"
+
+class ResponseCurve
+{
+public:
+    using Mode = LadderKernel::Mode;
+
+    struct Settings
+    {
+        double sampleRate;
+        float cutoff;
+        float resonance;
+        float trimDecibels;
+        Mode mode;
+    };
+
+    ResponseCurve();
+
+    //Brings the curve up to date and returns the magnitudes in dB, one per getFrequency(index)
+    const std::vector<float>& update(const Settings& settings);
+
+    //Bumped whenever update() changes the magnitudes
+    int getVersion() const { return version; }
+
+    static double getFrequency(int index);
+
+    static constexpr int numPoints = 256;
+    static constexpr double minFrequency = 20.0;
+    static constexpr double maxFrequency = 20000.0;
+
+private:
+
+    void updateUnitDelays();
+    void updateStageResponses();
+    void updateFilterMagnitudes();
+    void updateOutput();
+
+    Settings current { 0.0, 0.0f, -1.0f, 0.0f, Mode::LPF12 };
+
+    std::vector<std::complex<double>> unitDelays;
+    std::vector<std::complex<double>> stageResponses;
+    std::vector<float> filterMagnitudes, magnitudes;
+    int version = 0;
+};
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    ResponseCurveComponent.h
+
+    Overlays the processor's shared ResponseCurve on the analyzer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+class ResponseCurveComponent : public juce::Component, private juce::Timer
+{
+public:
+    ResponseCurveComponent(LadderFilterAudioProcessor& p) : audioProcessor(p)
+    {
+        setInterceptsMouseClicks(false, false);
+        startTimerHz(30);
+    }
+
+    ~ResponseCurveComponent() override
+    {
+        stopTimer();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.setColour(juce::Colour::fromFloatRGBA(0.392f, 0.584f, 0.929f, 0.75f));
+        g.strokePath(curvePath, juce::PathStrokeType(2.0f));
+    }
+
+    void resized() override
+    {
+        drawnVersion = -1;
+        timerCallback();
+    }
+
+private:
+
+    void timerCallback() override
+    {
+        auto& curve = audioProcessor.responseCurve;
+        const auto& magnitudes = curve.update(audioProcessor.getResponseSettings());
+
+        if (curve.getVersion() == drawnVersion)
+            return;
+
+        drawnVersion = curve.getVersion();
+        curvePath.clear();
+
+        for (int i = 0; i < ResponseCurve::numPoints; i++) {
+            auto x = getWidth() * i / float (ResponseCurve::numPoints - 1);
+            auto y = juce::jmap(juce::jlimit(minDecibels, maxDecibels, magnitudes[i]), minDecibels, maxDecibels, (float) getHeight(), 0.0f);
+
+            if (i == 0)
+                curvePath.startNewSubPath(x, y);
+            else
+                curvePath.lineTo(x, y);
+            }
+
+        repaint();
+    }
+
+    static constexpr float minDecibels = -48.0f;
+    static constexpr float maxDecibels = 24.0f;
+
+    LadderFilterAudioProcessor& audioProcessor;
+    juce::Path curvePath;
+    int drawnVersion = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseCurveComponent)
+};
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    SharedWorkerPool.cpp
+
+  ==============================================================================
+*/
+
+#include "SharedWorkerPool.h"
+#include <algorithm>
+
+struct SharedWorkerPool::ClientQueue
+{
+    std::deque<Job> jobs;
+    int running = 0;
+};
+
+namespace
+{
+    //set on the pool's threads, and to the owner's queue while a job runs
+    thread_local bool onWorkerThread = false;
+    thread_local const void* runningQueue = nullptr;
+}
+
+//==============================================================================
+SharedWorkerPool::Client::Client()
+    : pool(acquire()), queue(std::make_shared<ClientQueue>())
+{
+    pool->addClient(queue);
+}
+
+SharedWorkerPool::Client::~Client()
+{
+    //the last client joins the workers, which one of them can't do, and nothing may outlive the plugin binary
+    jassert (! onWorkerThread);
+    pool->removeClient(*queue);
+}
+
+void SharedWorkerPool::Client::submit(Job job)
+{
+    //notified under the lock, the job may destroy this client as soon as the lock is released
+    std::lock_guard<std::mutex> guard (pool->lock);
+    queue->jobs.push_back(std::move(job));
+    pool->jobAvailable.notify_one();
+}
+
+void SharedWorkerPool::Client::cancelPending()
+{
+    std::lock_guard<std::mutex> guard (pool->lock);
+    queue->jobs.clear();
+}
+
+void SharedWorkerPool::Client::cancelAndWait()
+{
+    std::unique_lock<std::mutex> guard (pool->lock);
+    pool->cancelAndWait(*queue, guard);
+}
+
+int SharedWorkerPool::Client::getNumOutstandingJobs() const
+{
+    std::lock_guard<std::mutex> guard (pool->lock);
+    return (int) queue->jobs.size() + queue->running;
+}
+
+//==============================================================================
+std::shared_ptr<SharedWorkerPool> SharedWorkerPool::acquire()
+{
+    static std::mutex instanceLock;
+    static std::weak_ptr<SharedWorkerPool> instance;
+    
+    std::lock_guard<std::mutex> guard (instanceLock);
+    auto pool = instance.lock();
+    
+    if (pool == nullptr) {
+        pool.reset(new SharedWorkerPool());
+        instance = pool;
+        }
+    
+    return pool;
+}
+
+SharedWorkerPool::SharedWorkerPool()
+{
+    //leave a core for the audio thread and never more than a few threads in total
+    auto numThreads = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() - 1);
+    
+    for (auto i = 0; i < numThreads; i++)
+        workers.emplace_back([this] { workerLoop(); });
+}
+
+SharedWorkerPool::~SharedWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard (lock);
+        shouldExit = true;
+    }
+    
+    jobAvailable.notify_all();
+    
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void SharedWorkerPool::addClient(std::shared_ptr<ClientQueue> queue)
+{
+    std::lock_guard<std::mutex> guard (lock);
+    clients.push_back(std::move(queue));
+}
+
+void SharedWorkerPool::removeClient(ClientQueue& queue)
+{
+    std::unique_lock<std::mutex> guard (lock);
+    cancelAndWait(queue, guard);
+    clients.erase(std::remove_if(clients.begin(), clients.end(), [&queue] (const std::shared_ptr<ClientQueue>& q) { return q.get() == &queue; }), clients.end());
+}
+
+void SharedWorkerPool::cancelAndWait(ClientQueue& queue, std::unique_lock<std::mutex>& guard)
+{
+    queue.jobs.clear();
+    
+    //the job may reference the client's owner, so it has to finish first,
+    //unless that job is the caller, which can only finish after this returns
+    const auto ownJob = runningQueue == &queue ? 1 : 0;
+    jobFinished.wait(guard, [&queue, ownJob] { return queue.running == ownJob; });
+}
+
+bool SharedWorkerPool::popNextJob(Job& job, std::shared_ptr<ClientQueue>& owner)
+{
+    //round robin over the clients, one job each
+    for (size_t i = 0; i < clients.size(); i++) {
+        auto& candidate = clients[(nextClient + i) % clients.size()];
+        
+        if (! candidate->jobs.empty()) {
+            job = std::move(candidate->jobs.front());
+            candidate->jobs.pop_front();
+            candidate->running++;
+            owner = candidate;
+            nextClient = (nextClient + i + 1) % clients.size();
+            return true;
+            }
+        }
+    
+    return false;
+}
+
+void SharedWorkerPool::workerLoop()
+{
+    juce::Thread::setCurrentThreadName("Ladder Worker");
+    onWorkerThread = true;
+    
+    std::unique_lock<std::mutex> guard (lock);
+    
+    while (! shouldExit) {
+        Job job;
+        std::shared_ptr<ClientQueue> owner;
+        
+        if (! popNextJob(job, owner)) {
+            jobAvailable.wait(guard);
+            continue;
+            }
+        
+        guard.unlock();
+        runningQueue = owner.get();
+        job();
+        job = nullptr;
+        runningQueue = nullptr;
+        guard.lock();
+        
+        owner->running--;
+        jobFinished.notify_all();
+        }
+}
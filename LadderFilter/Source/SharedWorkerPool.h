@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    SharedWorkerPool.h
+
+    One small set of background threads shared by every plugin instance in
+    the process, so a large session doesn't end up with a thread per
+    instance. Each user of the pool holds a Client; the pool is created with
+    the first client and its threads are joined when the last one goes away.
+    Clients have to be destroyed off the pool's threads, never from a job.
+    Workers take jobs from the clients in turn, so one busy client can't
+    starve the others.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class SharedWorkerPool
+{
+public:
+    using Job = std::function<void()>;
+
+private:
+    struct ClientQueue;
+
+public:
+    class Client
+    {
+    public:
+        Client();
+
+        //Drops anything still queued and waits for a running job to finish. Not from a worker thread.
+        ~Client();
+
+        void submit(Job job);
+        void cancelPending();
+
+        //Drops anything queued and waits for a running job, the client stays usable. Safe to call
+        //from one of this client's own jobs, which is then the one that isn't waited for.
+        void cancelAndWait();
+
+        //Number of queued plus running jobs
+        int getNumOutstandingJobs() const;
+
+    private:
+        std::shared_ptr<SharedWorkerPool> pool;
+        std::shared_ptr<ClientQueue> queue;
+
+        JUCE_DECLARE_NON_COPYABLE (Client)
+    };
+
+    ~SharedWorkerPool();
+
+    int getNumThreads() const { return (int) workers.size(); }
+
+private:
+
+    SharedWorkerPool();
+
+    static std::shared_ptr<SharedWorkerPool> acquire();
+
+    void addClient(std::shared_ptr<ClientQueue> queue);
+    void removeClient(ClientQueue& queue);
+    void cancelAndWait(ClientQueue& queue, std::unique_lock<std::mutex>& guard);
+    void workerLoop();
+    bool popNextJob(Job& job, std::shared_ptr<ClientQueue>& owner);
+
+    std::mutex lock;
+    std::condition_variable jobAvailable, jobFinished;
+    std::vector<std::shared_ptr<ClientQueue>> clients;
+    size_t nextClient = 0;
+    bool shouldExit = false;
+
+    std::vector<std::thread> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedWorkerPool)
+};
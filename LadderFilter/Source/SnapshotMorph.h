@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    SnapshotMorph.h
+
+    A/B (and C/D) snapshots of every parameter, and the morph between two of
+    them. Continuous parameters are interpolated, frequencies in the log
+    domain, and choices switch over at the midpoint. The message thread
+    stores snapshots; the audio thread reads them through a double buffer at
+    the start of a block, so a whole snapshot always lands at once and the
+    audio thread never waits.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetBank.h"
+#include <thread>
+
+//one value per parameter, in PresetFormat::parameterIds order
+using Snapshot = PresetFormat::Values;
+
+class SnapshotMorph
+{
+public:
+    static constexpr int numSlots = 4;
+
+    //none leaves the value morph() is given, for the parameters that run the morph itself
+    enum class Interpolation { none, linear, logarithmic, step };
+    using Interpolations = std::array<Interpolation, PresetFormat::numParameters>;
+
+    //every slot starts out as initial
+    SnapshotMorph(const Snapshot& initial, const Interpolations& parameterInterpolations)
+        : interpolations(parameterInterpolations)
+    {
+        slots.fill(initial);
+        buffers[0] = slots;
+        buffers[1] = slots;
+    }
+
+    //Message thread
+    void store(int slot, const Snapshot& snapshot)
+    {
+        if (! juce::isPositiveAndBelow(slot, numSlots))
+            return;
+
+        const juce::SpinLock::ScopedLockType lock (slotLock);
+        slots[(size_t) slot] = snapshot;
+        publish();
+    }
+
+    Snapshot get(int slot) const
+    {
+        const juce::SpinLock::ScopedLockType lock (slotLock);
+        return slots[(size_t) juce::jlimit(0, numSlots - 1, slot)];
+    }
+
+    //State chunk written after the preset: "LFSP", slot count, value count, then the values of each
+    //slot in parameterIds order. Parameters are appended the same way they are in presets.
+    void write(juce::OutputStream& stream) const
+    {
+        const juce::SpinLock::ScopedLockType lock (slotLock);
+        stream.write(getChunkMagic(), 4);
+        stream.writeShort((short) numSlots);
+        stream.writeShort((short) PresetFormat::numParameters);
+
+        for (auto& slot : slots)
+            for (auto value : slot)
+                stream.writeFloat(value);
+    }
+
+    //Decodes a chunk into a SNAPSHOTS tree, SLOT children with a property per parameter id, or
+    //returns an invalid tree if there isn't one. The first chunks, "LFSN", held four values per
+    //slot: drive, cutoff, resonance and trim, which still lead parameterIds.
+    static juce::ValueTree read(juce::InputStream& stream)
+    {
+        char magic[4];
+
+        if (stream.read(magic, 4) != 4)
+            return {};
+
+        const bool firstVersion = std::memcmp(magic, "LFSN", 4) == 0;
+
+        if (! firstVersion && std::memcmp(magic, getChunkMagic(), 4) != 0)
+            return {};
+
+        const int count = (juce::uint16) stream.readShort();
+        const int numValues = firstVersion ? 4 : (juce::uint16) stream.readShort();
+
+        if (stream.getNumBytesRemaining() < (juce::int64) count * numValues * 4)
+            return {};
+
+        juce::ValueTree tree (getTreeType());
+
+        for (int i = 0; i < count; i++) {
+            juce::ValueTree slot ("SLOT");
+
+            //values past the ones we know are from a newer build, read and dropped
+            for (int v = 0; v < numValues; v++) {
+                const auto value = stream.readFloat();
+
+                if (v < PresetFormat::numParameters)
+                    slot.setProperty(PresetFormat::parameterIds[v], value, nullptr);
+                }
+
+            tree.appendChild(slot, nullptr);
+            }
+
+        return tree;
+    }
+
+    //Message thread. The tree comes from a session, so every value is clamped to [lowest, highest].
+    //A value that's missing or isn't a finite number comes from fallback, the session's own
+    //parameters, so a slot saved before a parameter was in the snapshots leaves it where it was.
+    void restore(const juce::ValueTree& tree, const Snapshot& lowest, const Snapshot& highest, const Snapshot& fallback)
+    {
+        for (int i = 0; i < juce::jmin(numSlots, tree.getNumChildren()); i++) {
+            auto slot = tree.getChild(i);
+            Snapshot snapshot;
+
+            for (size_t v = 0; v < snapshot.size(); v++) {
+                const auto value = (double) slot.getProperty(PresetFormat::parameterIds[v], fallback[v]);
+                snapshot[v] = std::isfinite(value) ? juce::jlimit(lowest[v], highest[v], (float) value) : fallback[v];
+                }
+
+            store(i, snapshot);
+            }
+    }
+
+    static juce::Identifier getTreeType() { return "SNAPSHOTS"; }
+
+    //Audio thread. Replaces values with the morph from one slot to the other, each parameter by
+    //its interpolation; the ones marked none keep what they were given.
+    void morph(int fromSlot, int toSlot, float amount, Snapshot& values) const noexcept
+    {
+        fromSlot = juce::jlimit(0, numSlots - 1, fromSlot);
+        toSlot = juce::jlimit(0, numSlots - 1, toSlot);
+        amount = juce::jlimit(0.0f, 1.0f, amount);
+
+        //claim the front buffer, and make sure it was still the front once claimed
+        int index;
+
+        do {
+            index = front.load();
+            reading.store(index);
+            } while (index != front.load());
+
+        const auto from = buffers[index][(size_t) fromSlot];
+        const auto to = buffers[index][(size_t) toSlot];
+        reading.store(-1);
+
+        for (size_t i = 0; i < values.size(); i++) {
+            switch (interpolations[i]) {
+                case Interpolation::linear: values[i] = from[i] + (to[i] - from[i]) * amount; break;
+                case Interpolation::logarithmic: values[i] = from[i] * std::pow(to[i] / from[i], amount); break;
+                case Interpolation::step: values[i] = amount < 0.5f ? from[i] : to[i]; break;
+                case Interpolation::none: break;
+                }
+            }
+    }
+
+private:
+
+    using Slots = std::array<Snapshot, numSlots>;
+
+    void publish()
+    {
+        const auto back = 1 - front.load();
+
+        //the audio thread can only be holding the back buffer if it claimed it just before the last swap
+        while (reading.load() == back)
+            std::this_thread::yield();
+
+        buffers[back] = slots;
+        front.store(back);
+    }
+
+    static const char* getChunkMagic() { return "LFSP"; }
+
+    const Interpolations interpolations;
+    mutable juce::SpinLock slotLock;
+    Slots slots;
+    Slots buffers[2];
+    std::atomic<int> front { 0 };
+    mutable std::atomic<int> reading { -1 };
+};
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.cpp
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+
+SpectrumAnalyzer::SpectrumAnalyzer(AnalyzerFifo& fifoToUse)
+    : fifo(fifoToUse),
+      fft(fftOrder),
+      window(fftSize, juce::dsp::WindowingFunction<float>::hann, true)
+{
+    incoming.resize(fftSize, 0.0f);
+    ring.resize(fftSize, 0.0f);
+    fftData.resize(fftSize * 2, 0.0f);
+    smoothed.resize(numBins, minDecibels);
+    published.resize(numBins, minDecibels);
+    
+    fifo.setActive(true);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    fifo.setActive(false);
+    workers.cancelPending();
+}
+
+void SpectrumAnalyzer::requestUpdate()
+{
+    if (updatePending.exchange(true))
+        return;
+    
+    workers.submit([this] {
+        drainFifo();
+        updatePending = false;
+    });
+}
+
+bool SpectrumAnalyzer::getLevels(std::vector<float>& dest)
+{
+    const juce::SpinLock::ScopedLockType lock (publishLock);
+    
+    if (! hasNewLevels)
+        return false;
+    
+    dest = published;
+    hasNewLevels = false;
+    return true;
+}
+
+void SpectrumAnalyzer::drainFifo()
+{
+    for (int numRead; (numRead = fifo.pull(incoming.data(), (int) incoming.size())) > 0;) {
+        
+        auto frameDecimation = decimation.load();
+        
+        //paused, throw the samples away so the fifo never fills up
+        if (frameDecimation <= 0)
+            continue;
+        
+        for (int i = 0; i < numRead; i++) {
+            ring[ringPosition] = incoming[i];
+            ringPosition = (ringPosition + 1) % fftSize;
+            
+            if (++samplesSinceHop == hopSize) {
+                samplesSinceHop = 0;
+                
+                if (++hopsSinceFrame >= frameDecimation) {
+                    hopsSinceFrame = 0;
+                    analyseFrame();
+                    }
+                }
+            }
+        }
+}
+
+void SpectrumAnalyzer::analyseFrame()
+{
+    //unwrap the ring so the oldest sample comes first
+    std::copy(ring.begin() + ringPosition, ring.end(), fftData.begin());
+    std::copy(ring.begin(), ring.begin() + ringPosition, fftData.begin() + (fftSize - ringPosition));
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    
+    window.multiplyWithWindowingTable(fftData.data(), fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+    
+    //fast attack, slow release so the display doesn't flicker
+    const auto normalise = 2.0f / (float) fftSize;
+    
+    for (int bin = 0; bin < numBins; bin++) {
+        auto level = juce::Decibels::gainToDecibels(fftData[bin] * normalise, minDecibels);
+        smoothed[bin] = level > smoothed[bin] ? level : smoothed[bin] + (level - smoothed[bin]) * 0.2f;
+        }
+    
+    const juce::SpinLock::ScopedLockType lock (publishLock);
+    std::copy(smoothed.begin(), smoothed.end(), published.begin());
+    hasNewLevels = true;
+}
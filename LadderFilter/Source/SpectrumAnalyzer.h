@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+
+    Pulls samples from an AnalyzerFifo and turns them into smoothed
+    magnitude spectra on the shared worker pool, so none of the FFT work
+    lands on the audio thread. The UI calls requestUpdate() from its timer
+    and picks up the latest spectrum with getLevels().
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalyzerFifo.h"
+#include "SharedWorkerPool.h"
+
+class SpectrumAnalyzer
+{
+public:
+    SpectrumAnalyzer(AnalyzerFifo& fifoToUse);
+    ~SpectrumAnalyzer();
+
+    //Queues a job that drains the fifo, unless one is still pending
+    void requestUpdate();
+
+    //1 analyses every hop, N every Nth hop, 0 pauses analysis and just drains the fifo
+    void setDecimation(int newDecimation) { decimation.store(newDecimation); }
+
+    //Copies the latest spectrum in dB (numBins values) and returns false if nothing new was published
+    bool getLevels(std::vector<float>& dest);
+
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = fftSize / 2;
+    static constexpr float minDecibels = -96.0f;
+
+private:
+
+    void drainFifo();
+    void analyseFrame();
+
+    static constexpr int hopSize = fftSize / 2;
+
+    AnalyzerFifo& fifo;
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+
+    std::vector<float> incoming, ring, fftData, smoothed, published;
+    int ringPosition = 0;
+    int samplesSinceHop = 0;
+    int hopsSinceFrame = 0;
+
+    std::atomic<int> decimation { 1 };
+
+    juce::SpinLock publishLock;
+    bool hasNewLevels = false;
+
+    std::atomic<bool> updatePending { false };
+
+    //declared last so pending jobs are finished before anything else is destroyed
+    SharedWorkerPool::Client workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzer)
+};
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    StereoLadder.h
+
+    Drive, ladder and trim with separate settings for each side of a stereo
+    pair: mid and side, or left and right. The two paths are neighbouring
+    lanes of one LadderLanes group, so they step together and cost about
+    the same as one channel of the single chain. Mid/side encoding happens
+    while the channels are gathered into lane frames, and decoding happens
+    while the frames are scattered back, so neither takes a pass of its own.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../LadderCore/Source/LadderLanes.h"
+
+class StereoLadder
+{
+public:
+    enum class Layout { midSide, leftRight };
+
+    using Lanes = LadderLanes<4>;
+    using Settings = Lanes::Settings;
+
+    StereoLadder() = default;
+
+    void prepare(double sampleRate)
+    {
+        lanes.prepare(sampleRate);
+        frames.fill(0.0f);
+    }
+
+    void reset() noexcept
+    {
+        lanes.reset();
+    }
+
+    //first is mid or left, second is side or right
+    void setSettings(const Settings& first, const Settings& second) noexcept
+    {
+        lanes.setLane(0, first);
+        lanes.setLane(1, second);
+    }
+
+    //needs both channels, a mono bus stays on the single chain
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, Layout layout) noexcept
+    {
+        jassert(buffer.getNumChannels() >= 2);
+
+        auto* left = buffer.getWritePointer(0, startSample);
+        auto* right = buffer.getWritePointer(1, startSample);
+        const bool midSide = layout == Layout::midSide;
+
+        for (int offset = 0; offset < numSamples; offset += chunkSize) {
+            const auto count = juce::jmin(chunkSize, numSamples - offset);
+
+            for (int i = 0; i < count; i++) {
+                const auto l = left[offset + i];
+                const auto r = right[offset + i];
+                auto* frame = frames.data() + (size_t) (i * Lanes::lanes);
+
+                frame[0] = midSide ? (l + r) * 0.5f : l;
+                frame[1] = midSide ? (l - r) * 0.5f : r;
+                }
+
+            lanes.process(frames.data(), count);
+
+            for (int i = 0; i < count; i++) {
+                const auto* frame = frames.data() + (size_t) (i * Lanes::lanes);
+
+                left[offset + i] = midSide ? frame[0] + frame[1] : frame[0];
+                right[offset + i] = midSide ? frame[0] - frame[1] : frame[1];
+                }
+            }
+    }
+
+private:
+
+    //lanes 2 and 3 are never written, so they stay silent
+    static constexpr int chunkSize = 64;
+
+    Lanes lanes;
+    std::array<float, chunkSize * Lanes::lanes> frames {};
+
+    JUCE_DECLARE_NON_COPYABLE (StereoLadder)
+};
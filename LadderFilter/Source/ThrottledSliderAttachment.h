@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    ThrottledSliderAttachment.h
+
+    Connects a slider to a parameter like APVTS::SliderAttachment, but
+    parameter changes only mark the slider dirty. The editor pushes dirty
+    values to the slider from its frame timer, so automation repaints are
+    coalesced to the editor's frame rate instead of one per host update.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class ThrottledSliderAttachment : private juce::AudioProcessorParameter::Listener,
+                                  private juce::Slider::Listener
+{
+public:
+    ThrottledSliderAttachment(juce::AudioProcessorValueTreeState& stateToUse, const juce::String& parameterID, juce::Slider& sliderToControl)
+        : slider(sliderToControl), parameter(*stateToUse.getParameter(parameterID))
+    {
+        auto range = parameter.getNormalisableRange();
+        slider.setNormalisableRange({ range.start, range.end, range.interval, range.skew });
+        slider.setDoubleClickReturnValue(true, range.convertFrom0to1(parameter.getDefaultValue()));
+
+        pushToSlider();
+
+        parameter.addListener(this);
+        slider.addListener(this);
+    }
+
+    ~ThrottledSliderAttachment() override
+    {
+        slider.removeListener(this);
+        parameter.removeListener(this);
+    }
+
+    //Call from the message thread at the frame rate
+    void flush()
+    {
+        if (needsUpdate.exchange(false))
+            pushToSlider();
+    }
+
+private:
+
+    void pushToSlider()
+    {
+        const juce::ScopedValueSetter<bool> svs (ignoreSliderCallbacks, true);
+        slider.setValue(parameter.convertFrom0to1(parameter.getValue()), juce::dontSendNotification);
+    }
+
+    //Can be called from any thread, including the audio thread
+    void parameterValueChanged(int, float) override { needsUpdate = true; }
+    void parameterGestureChanged(int, bool) override {}
+
+    void sliderValueChanged(juce::Slider*) override
+    {
+        if (! ignoreSliderCallbacks)
+            parameter.setValueNotifyingHost(parameter.convertTo0to1((float) slider.getValue()));
+    }
+
+    void sliderDragStarted(juce::Slider*) override { parameter.beginChangeGesture(); }
+    void sliderDragEnded(juce::Slider*) override { parameter.endChangeGesture(); }
+
+    juce::Slider& slider;
+    juce::RangedAudioParameter& parameter;
+    std::atomic<bool> needsUpdate { false };
+    bool ignoreSliderCallbacks = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThrottledSliderAttachment)
+};
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    EditorLoadBenchmark.cpp
+
+    Message-thread time per second with many editors open while a host
+    plays and automates them: n instances, each editor in a window of its
+    own, and a host thread that runs every instance's processBlock in real
+    time and moves its first four parameters (drive, cutoff, resonance and
+    trim) before each block. Prints the CPU time the message thread spent
+    per second of wall time over the measured run, which takes in the
+    editors' timers, parameter callbacks and repaints. Time the thread spent
+    waiting for events doesn't count.
+
+        EditorLoadBenchmark [--editors n] [--seconds n]
+
+    Only the AudioProcessor and editor interfaces are used, so it builds
+    against any revision of the plugin. For before and after figures,
+    configure a second build with -DLADDER_PLUGIN_SOURCE_DIR set to
+    LadderFilter/Source in a worktree of the older commit, and run both on
+    the same machine and display. Needs a display, xvfb-run is enough;
+    POSIX only, for the thread CPU clock.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <time.h>
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    struct Options
+    {
+        int editors = 20;
+        double seconds = 10.0;
+    };
+
+    //CPU time of the calling thread, so the message loop's waiting isn't counted
+    double getThreadSeconds()
+    {
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return (double) now.tv_sec + (double) now.tv_nsec * 1.0e-9;
+    }
+
+    //plays every instance one block at a time, in real time, automating it before each block
+    class Host  : public juce::Thread
+    {
+    public:
+        explicit Host(std::vector<std::unique_ptr<juce::AudioProcessor>>& processorsToPlay)
+            : juce::Thread ("Host"), processors(processorsToPlay)
+        {
+            juce::Random random (1);
+            noise.setSize(2, blockSize);
+
+            for (int channel = 0; channel < noise.getNumChannels(); channel++)
+                for (int i = 0; i < blockSize; i++)
+                    noise.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+            for (auto& processor : processors)
+                buffers.emplace_back(juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()), blockSize);
+        }
+
+        void run() override
+        {
+            const auto blockTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double> (blockSize / sampleRate));
+            auto next = std::chrono::steady_clock::now();
+            juce::MidiBuffer midi;
+
+            for (long block = 0; ! threadShouldExit(); block++) {
+                for (size_t i = 0; i < processors.size(); i++) {
+                    auto& parameters = processors[i]->getParameters();
+
+                    //slow sweeps, out of phase between instances and parameters, so every block moves all four
+                    for (int p = 0; p < juce::jmin(4, parameters.size()); p++)
+                        parameters[p]->setValueNotifyingHost(0.5f + 0.4f * std::sin(0.05f * (float) block + (float) (i + (size_t) p)));
+
+                    auto& buffer = buffers[i];
+
+                    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+                        buffer.copyFrom(channel, 0, noise, channel % 2, 0, blockSize);
+
+                    processors[i]->processBlock(buffer, midi);
+                    }
+
+                next += blockTime;
+                std::this_thread::sleep_until(next);
+                }
+        }
+
+    private:
+        std::vector<std::unique_ptr<juce::AudioProcessor>>& processors;
+        std::vector<juce::AudioBuffer<float>> buffers;
+        juce::AudioBuffer<float> noise;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--editors") == 0) options.editors = std::atoi(argv[i + 1]);
+            else if (std::strcmp(argv[i], "--seconds") == 0) options.seconds = std::strtod(argv[i + 1], nullptr);
+            else return false;
+            }
+
+        return argc % 2 == 1 && options.editors > 0 && options.seconds > 0.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (! parseOptions(argc, argv, options)) {
+        std::printf("usage: EditorLoadBenchmark [--editors n] [--seconds n]\n");
+        return 1;
+        }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    //editors go before their processors, and the host stops before either
+    std::vector<std::unique_ptr<juce::AudioProcessor>> processors;
+    std::vector<std::unique_ptr<juce::AudioProcessorEditor>> editors;
+
+    for (int i = 0; i < options.editors; i++) {
+        processors.emplace_back(createPluginFilter());
+        auto& processor = *processors.back();
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        editors.emplace_back(processor.createEditorIfNeeded());
+        auto& editor = *editors.back();
+        editor.setTopLeftPosition(40 + 20 * i, 40 + 20 * i);
+        editor.addToDesktop(juce::ComponentPeer::windowHasTitleBar);
+        editor.setVisible(true);
+        }
+
+    Host host (processors);
+
+    //a second for the windows to open and paint for the first time, then the measured run
+    double startCpu = 0.0, startWall = 0.0, cpu = 0.0, wall = 0.0;
+
+    juce::Timer::callAfterDelay(1000, [&] {
+        startCpu = getThreadSeconds();
+        startWall = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    });
+
+    juce::Timer::callAfterDelay(1000 + juce::roundToInt(options.seconds * 1000.0), [&] {
+        cpu = getThreadSeconds() - startCpu;
+        wall = juce::Time::getMillisecondCounterHiRes() * 0.001 - startWall;
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    });
+
+    host.startThread();
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    host.stopThread(1000);
+
+    std::printf("%d editors, %.1f s: message thread %.1f ms CPU per second (%.1f %%)\n",
+                options.editors, wall, cpu * 1000.0 / wall, cpu * 100.0 / wall);
+
+    editors.clear();
+    processors.clear();
+    return 0;
+}
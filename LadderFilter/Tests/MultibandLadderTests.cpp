@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    MultibandLadderTests.cpp
+
+    Crossover settings the parameters allow but the filters can't take:
+    every split at 20 kHz, splits out of order, and rates where 20 kHz is
+    at or past Nyquist. The band sum has to stay finite and bounded.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/MultibandLadder.h"
+#include <cstdio>
+
+int main()
+{
+    int failures = 0;
+
+    auto expect = [&failures] (bool condition, const char* what, double sampleRate, int numBands) {
+        if (! condition) {
+            std::printf("  failed: %s at %.0f Hz, %d bands\n", what, sampleRate, numBands);
+            failures++;
+            }
+    };
+
+    const std::array<float, MultibandLadder::maxBands - 1> settings[] = {
+        { 20000.0f, 20000.0f, 20000.0f },
+        { 20000.0f, 200.0f, 20.0f },
+        { 200.0f, 1000.0f, 5000.0f }
+    };
+
+    juce::Random random (1);
+
+    for (double sampleRate : { 22050.0, 32000.0, 44100.0, 96000.0 })
+        for (int numBands = 2; numBands <= MultibandLadder::maxBands; numBands++)
+            for (const auto& crossovers : settings) {
+                auto multiband = std::make_unique<MultibandLadder>();
+                multiband->prepare(sampleRate, 512);
+                multiband->setCrossovers(crossovers, numBands);
+
+                for (int band = 0; band < MultibandLadder::maxBands; band++)
+                    multiband->setBand(band, { 2.0f, 1000.0f, 0.5f, 0.0f, LadderKernel::Mode::LPF12 });
+
+                juce::AudioBuffer<float> buffer (MultibandLadder::maxChannels, 512);
+                float peak = 0.0f;
+                bool finite = true;
+
+                for (int block = 0; block < 40; block++) {
+                    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+                        for (int i = 0; i < buffer.getNumSamples(); i++)
+                            buffer.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+                    multiband->process(buffer, 0, buffer.getNumSamples(), numBands);
+
+                    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+                        for (int i = 0; i < buffer.getNumSamples(); i++) {
+                            const auto sample = buffer.getSample(channel, i);
+                            finite = finite && std::isfinite(sample);
+                            peak = juce::jmax(peak, std::abs(sample));
+                            }
+                    }
+
+                expect(finite, "output is finite", sampleRate, numBands);
+                expect(peak < 16.0f, "output is bounded", sampleRate, numBands);
+                }
+
+    if (failures > 0) {
+        std::printf("MultibandLadderTests: %d failed\n", failures);
+        return 1;
+        }
+
+    std::puts("MultibandLadderTests: passed");
+    return 0;
+}
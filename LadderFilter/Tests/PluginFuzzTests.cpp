@@ -0,0 +1,307 @@
+/*
+  ==============================================================================
+
+    PluginFuzzTests.cpp
+
+    FuzzTests in LadderCore drives LadderEngine, which has no prepared block
+    size. This drives the plugin's own processBlock, with the chunking,
+    MIDI splitting and chain switching the engine doesn't have: block
+    sizes from 0 to many times the size prepareToPlay announced, every
+    parameter set at random (the multiband, stereo, morph and modulation
+    chains included), MIDI events anywhere in and past the block, sessions
+    restored between blocks, and prepareToPlay and releaseResources again
+    at odd rates, block sizes and release policies.
+
+    After every block the output has to be finite, samples past the end
+    of the block have to be untouched, and the block has to have finished
+    within its time budget. The audio stays finite here: unlike the engine,
+    the plugin makes no promise about NaN in its input.
+
+        PluginFuzzTests [--seed n] [--steps n] [--budget fraction]
+
+    --budget works as in FuzzTests: the share of a block's real-time length
+    it may take, on top of a fixed 2 ms, and 0 for sanitizer builds. The
+    nightly job runs this next to FuzzTests in both of its builds.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+namespace
+{
+    //written past the end of every block
+    constexpr float guardValue = 12345.0f;
+    constexpr int guardSize = 16;
+    constexpr int maxBlockSize = 16384;
+
+    struct Options
+    {
+        unsigned int seed = 1;
+        long steps = 4000;
+        double budget = 0.5;
+    };
+
+    class Fuzzer
+    {
+    public:
+        explicit Fuzzer(const Options& o) : options(o), random(o.seed) {}
+
+        //false as soon as a check fails
+        bool run()
+        {
+            numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+            storage.setSize(numChannels, maxBlockSize + guardSize);
+            prepare();
+
+            for (step = 0; step < options.steps; step++) {
+                const auto event = pick(0, 99);
+
+                if (event < 60) processBlock();
+                else if (event < 85) setParameter();
+                else if (event < 90) restoreState();
+                else if (event < 97) prepare();
+                else release();
+
+                if (failed)
+                    return false;
+                }
+
+            std::printf("%ld steps, %ld blocks (%ld samples), %d prepares, longest block %.3f ms\n",
+                        options.steps, blocks, samples, prepares, longestBlock * 1000.0);
+            return true;
+        }
+
+    private:
+        //----------------------------------------------------------------------
+        //not the standard distributions, so a seed means the same run everywhere
+        int pick(int minimum, int maximum)
+        {
+            return minimum + (int) (random() % (unsigned int) (maximum - minimum + 1));
+        }
+
+        float pickUniform(float minimum, float maximum)
+        {
+            return minimum + (maximum - minimum) * (float) (random() >> 8) * (1.0f / 16777216.0f);
+        }
+
+        //mostly around the prepared size, sometimes empty, sometimes many times bigger
+        int pickBlockSize()
+        {
+            const auto kind = pick(0, 19);
+
+            if (kind < 2) return 0;
+            if (kind < 6) return pick(1, 16);
+            if (kind < 16) return pick(17, preparedBlockSize);
+            return pick(preparedBlockSize, maxBlockSize);
+        }
+
+        bool check(bool condition, const char* what)
+        {
+            if (! condition && ! failed) {
+                std::printf("FAILED seed %u step %ld: %s (rate %g, %d samples prepared)\n",
+                            options.seed, step, what, sampleRate, preparedBlockSize);
+                failed = true;
+                }
+
+            return condition;
+        }
+
+        //----------------------------------------------------------------------
+        void prepare()
+        {
+            const double rates[] = { 8000.0, 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 192000.0, 11025.0, 37800.0 };
+            const int blockSizes[] = { 1, 16, 64, 100, 256, 441, 512, 1024, 4096 };
+
+            sampleRate = rates[pick(0, 8)];
+            preparedBlockSize = blockSizes[pick(0, 8)];
+            processor.prepareToPlay(sampleRate, preparedBlockSize);
+            prepares++;
+        }
+
+        //the host always prepares again before the next block
+        void release()
+        {
+            const PrepareCache::ReleasePolicy policies[] = { PrepareCache::ReleasePolicy::keepEverything,
+                                                             PrepareCache::ReleasePolicy::freeBuffers,
+                                                             PrepareCache::ReleasePolicy::freeEverything };
+            processor.setReleasePolicy(policies[pick(0, 2)]);
+            processor.releaseResources();
+            prepare();
+        }
+
+        //anywhere in the range, with the ends more often than chance would pick them
+        void setParameter()
+        {
+            const auto& parameters = processor.getParameters();
+            auto* parameter = parameters[pick(0, parameters.size() - 1)];
+            const auto kind = pick(0, 3);
+            parameter->setValueNotifyingHost(kind == 0 ? 0.0f : kind == 1 ? 1.0f : pickUniform(0.0f, 1.0f));
+        }
+
+        //a session saved now, or one from earlier in the run
+        void restoreState()
+        {
+            if (sessions.size() < 8 || pick(0, 1) == 0) {
+                sessions.emplace_back();
+                processor.getStateInformation(sessions.back());
+                }
+            else {
+                const auto& session = sessions[(size_t) pick(0, (int) sessions.size() - 1)];
+                processor.setStateInformation(session.getData(), (int) session.getSize());
+                }
+        }
+
+        //notes and controllers, some at the block's end or past it
+        void fillMidi(juce::MidiBuffer& midi, int numSamples)
+        {
+            for (int events = pick(0, 3) == 0 ? pick(1, 40) : 0; events > 0; events--) {
+                const auto position = pick(0, numSamples + 64);
+                const auto kind = pick(0, 2);
+
+                if (kind == 0) midi.addEvent(juce::MidiMessage::noteOn(1, pick(0, 127), (juce::uint8) pick(1, 127)), position);
+                else if (kind == 1) midi.addEvent(juce::MidiMessage::noteOff(1, pick(0, 127)), position);
+                else midi.addEvent(juce::MidiMessage::controllerEvent(pick(1, 16), pick(0, 127), pick(0, 127)), position);
+                }
+        }
+
+        //noise, silence, DC, denormals or loud, every channel including the sidechain's
+        void fillSignal(float* data, int numSamples)
+        {
+            const auto kind = pick(0, 5);
+            const float levels[] = { 1.0e-6f, 0.01f, 0.5f, 1.0f, 4.0f, 1000.0f };
+            const auto level = levels[pick(0, 5)];
+
+            for (int i = 0; i < numSamples; i++) {
+                switch (kind) {
+                    case 0: data[i] = 0.0f; break;
+                    case 1: data[i] = level; break;
+                    case 2: data[i] = pickUniform(-1.0f, 1.0f) * 1.0e-38f; break;
+                    default: data[i] = pickUniform(-level, level); break;
+                    }
+                }
+        }
+
+        void processBlock()
+        {
+            const auto numSamples = pickBlockSize();
+
+            for (int channel = 0; channel < numChannels; channel++) {
+                auto* data = storage.getWritePointer(channel);
+                fillSignal(data, numSamples);
+                std::fill(data + numSamples, data + numSamples + guardSize, guardValue);
+                }
+
+            //the host's buffer is exactly the block, the guard samples sit just past it
+            juce::AudioBuffer<float> buffer (storage.getArrayOfWritePointers(), numChannels, numSamples);
+            juce::MidiBuffer midi;
+            fillMidi(midi, numSamples);
+            timeBlock(buffer, midi);
+
+            for (int channel = 0; channel < numChannels; channel++) {
+                const auto* data = storage.getReadPointer(channel);
+
+                for (int i = 0; i < numSamples; i++)
+                    if (! check(std::isfinite(data[i]), "output not finite"))
+                        return;
+
+                for (int i = numSamples; i < numSamples + guardSize; i++)
+                    if (! check(data[i] == guardValue, "wrote past the end of the block"))
+                        return;
+                }
+
+            blocks++;
+            samples += numSamples;
+        }
+
+        template <typename Function>
+        static double timeOnce(Function&& function)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count();
+        }
+
+        //Runs the block and checks it kept to the budget. The processor can't be copied, so a block
+        //over budget is timed again on the same input from where the first run left the processor:
+        //one preemption by the scheduler doesn't fail the run, a slow path shows up both times.
+        void timeBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+        {
+            const auto numSamples = buffer.getNumSamples();
+            juce::AudioBuffer<float> input;
+            input.makeCopyOf(buffer);
+            const auto midiBefore = midi;
+
+            auto elapsed = timeOnce([&] { processor.processBlock(buffer, midi); });
+            const auto budget = options.budget * numSamples / sampleRate + 0.002;
+
+            if (options.budget > 0.0 && elapsed > budget) {
+                juce::AudioBuffer<float> again;
+                again.makeCopyOf(input);
+                auto midiAgain = midiBefore;
+                elapsed = std::min(elapsed, timeOnce([&] { processor.processBlock(again, midiAgain); }));
+
+                check(elapsed <= budget, ("block of " + std::to_string(numSamples) + " samples took "
+                                          + std::to_string(elapsed * 1000.0) + " ms twice").c_str());
+                }
+
+            longestBlock = std::max(longestBlock, elapsed);
+        }
+
+        //----------------------------------------------------------------------
+        Options options;
+        long step = 0;
+        std::mt19937 random;
+
+        LadderFilterAudioProcessor processor;
+        juce::AudioBuffer<float> storage;
+        std::vector<juce::MemoryBlock> sessions;
+        int numChannels = 0, preparedBlockSize = 512, prepares = 0;
+        double sampleRate = 48000.0;
+        long blocks = 0, samples = 0;
+        double longestBlock = 0.0;
+        bool failed = false;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--seed") == 0) options.seed = (unsigned int) std::strtoul(argv[i + 1], nullptr, 10);
+            else if (std::strcmp(argv[i], "--steps") == 0) options.steps = std::strtol(argv[i + 1], nullptr, 10);
+            else if (std::strcmp(argv[i], "--budget") == 0) options.budget = std::strtod(argv[i + 1], nullptr);
+            else return false;
+            }
+
+        return argc % 2 == 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+
+    if (! parseOptions(argc, argv, options)) {
+        std::printf("usage: PluginFuzzTests [--seed n] [--steps n] [--budget fraction]\n");
+        return 1;
+        }
+
+    std::printf("seed %u\n", options.seed);
+
+    //a message manager exists, but nothing ever runs its loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    Fuzzer fuzzer (options);
+
+    if (! fuzzer.run())
+        return 1;
+
+    std::puts("PluginFuzzTests: passed");
+    return 0;
+}
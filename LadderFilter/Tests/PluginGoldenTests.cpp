@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    PluginGoldenTests.cpp
+
+    The plugin's own processBlock held to the golden renders in
+    LadderCore/Tests/Golden, with the engine's tolerances. GoldenTests
+    covers LadderEngine and LadderLanes, which share the plugin's tables
+    and kernel but not its code; this runs the static path as a host
+    would: prepareToPlay, parameters set through the tree, 512-sample
+    blocks with a block boundary where the grid point changes its settings.
+
+    Each render starts after 100 ms of silence, so every ramp the first
+    block starts has settled and the filter state is still all zeros,
+    which is where ReferenceChain starts.
+
+        PluginGoldenTests <golden directory>
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "GoldenSet.h"
+
+namespace
+{
+    using namespace GoldenSet;
+
+    constexpr int blockSize = 512;
+    constexpr int settleSamples = 4800;
+
+    void setParameter(LadderFilterAudioProcessor& processor, const char* parameterId, float value)
+    {
+        auto* parameter = processor.treeState.getParameter(parameterId);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    void setSettings(LadderFilterAudioProcessor& processor, const Settings& settings)
+    {
+        setParameter(processor, driveSliderId, settings.drive);
+        setParameter(processor, cutoffSliderId, settings.cutoff);
+        setParameter(processor, resoDelaySliderId, settings.resonance);
+        setParameter(processor, trimSliderId, settings.trimDecibels);
+    }
+
+    //both output channels, rendered from the signal on both inputs
+    std::vector<std::vector<float>> renderPlugin(Mode mode, const GridPoint& point)
+    {
+        LadderFilterAudioProcessor processor;
+        setParameter(processor, filterModeId, (float) mode);
+        setSettings(processor, point.initial);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int settled = 0; settled < settleSamples; settled += blockSize) {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            }
+
+        const auto signal = makeSignal();
+        std::vector<std::vector<float>> outputs (2, std::vector<float> ((size_t) numSamples));
+
+        renderInBlocks(blockSize, point.changeAt,
+                       [&] (int start, int count) {
+                           buffer.setSize(numChannels, count, false, false, true);
+                           buffer.clear();
+
+                           for (int channel = 0; channel < 2; channel++)
+                               buffer.copyFrom(channel, 0, signal.data() + start, count);
+
+                           processor.processBlock(buffer, midi);
+
+                           for (int channel = 0; channel < 2; channel++)
+                               std::copy_n(buffer.getReadPointer(channel), count, outputs[(size_t) channel].begin() + start);
+                       },
+                       [&] { setSettings(processor, point.changed); });
+
+        processor.releaseResources();
+        return outputs;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::printf("usage: PluginGoldenTests <golden directory>\n");
+        return 1;
+        }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    std::vector<WavFile> references;
+
+    if (! load(argv[1], references))
+        return TestHelpers::finish("PluginGoldenTests");
+
+    for (int mode = 0; mode < numModes; mode++) {
+        Differences differences;
+
+        for (int point = 0; point < numGridPoints; point++)
+            for (const auto& output : renderPlugin((Mode) mode, grid[point]))
+                differences.add(output, references[(size_t) mode].channels[(size_t) point]);
+
+        check("plugin", mode, engineTolerances[mode], differences);
+        }
+
+    return TestHelpers::finish("PluginGoldenTests");
+}
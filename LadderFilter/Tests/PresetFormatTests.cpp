@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    PresetFormatTests.cpp
+
+    The compatibility rules in PresetBank.h: short presets keep defaults,
+    long ones drop the values we don't know, non-finite values keep
+    defaults, the ValueTree sessions saved before the format are migrated,
+    and newer presets and banks are read as far as we know them.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PresetBank.h"
+#include <cstdio>
+
+namespace
+{
+    int failures = 0;
+
+    void expect(bool condition, const char* what)
+    {
+        if (! condition) {
+            std::printf("  failed: %s\n", what);
+            failures++;
+            }
+    }
+
+    juce::MemoryBlock makePreset(int version, const std::vector<float>& values)
+    {
+        juce::MemoryOutputStream stream;
+        stream.write("LFPR", 4);
+        stream.writeShort((short) version);
+        stream.writeShort((short) values.size());
+
+        for (auto value : values)
+            stream.writeFloat(value);
+
+        return stream.getMemoryBlock();
+    }
+
+    PresetFormat::Values makeDefaults()
+    {
+        PresetFormat::Values values;
+
+        for (size_t i = 0; i < values.size(); i++)
+            values[i] = -1.0f - (float) i;
+
+        return values;
+    }
+}
+
+int main()
+{
+    const auto defaults = makeDefaults();
+
+    {
+        //round trip
+        auto written = defaults;
+        written[3] = 2.5f;
+        juce::MemoryOutputStream stream;
+        PresetFormat::write(written, stream);
+
+        auto read = defaults;
+        read[3] = 0.0f;
+        expect(PresetFormat::read(stream.getData(), stream.getDataSize(), read) && read == written, "round trip");
+    }
+
+    {
+        //an older, shorter preset leaves the parameters it doesn't store at their defaults
+        auto values = defaults;
+        auto data = makePreset(1, { 10.0f, 20.0f });
+        expect(PresetFormat::read(data.getData(), data.getSize(), values), "short preset is read");
+        expect(values[0] == 10.0f && values[1] == 20.0f, "short preset values");
+        expect(std::equal(values.begin() + 2, values.end(), defaults.begin() + 2), "short preset keeps defaults");
+    }
+
+    {
+        //a preset from a build with more parameters: ours are read, the extra ones dropped,
+        //and the stream ends up past all of them so whatever follows still lines up
+        std::vector<float> stored (PresetFormat::numParameters + 3, 0.5f);
+        auto data = makePreset(1, stored);
+        data.append("TAIL", 4);
+
+        auto values = defaults;
+        juce::MemoryInputStream stream (data, false);
+        expect(PresetFormat::read(stream, values), "long preset is read");
+        expect(std::all_of(values.begin(), values.end(), [] (float value) { return value == 0.5f; }), "long preset values");
+
+        char tail[4] = {};
+        expect(stream.read(tail, 4) == 4 && std::memcmp(tail, "TAIL", 4) == 0, "long preset skips its extra values");
+    }
+
+    {
+        auto values = defaults;
+        auto data = makePreset(1, { std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(), 3.0f });
+        expect(PresetFormat::read(data.getData(), data.getSize(), values), "non-finite preset is read");
+        expect(values[0] == defaults[0] && values[1] == defaults[1] && values[2] == 3.0f, "non-finite values keep defaults");
+    }
+
+    {
+        //backward: a session from before the binary format, matched by id whatever the order
+        juce::ValueTree tree ("PARAMETER");
+        tree.appendChild(juce::ValueTree ("PARAM", {{ "id", PresetFormat::parameterIds[3] }, { "value", -4.5 }}), nullptr);
+        tree.appendChild(juce::ValueTree ("PARAM", {{ "id", PresetFormat::parameterIds[0] }, { "value", 6.5 }}), nullptr);
+        tree.appendChild(juce::ValueTree ("PARAM", {{ "id", "noLongerAParameter" }, { "value", 1.0 }}), nullptr);
+        tree.appendChild(juce::ValueTree ("PARAM", {{ "id", PresetFormat::parameterIds[1] }}), nullptr);
+
+        juce::MemoryOutputStream stream;
+        tree.writeToStream(stream);
+
+        auto values = defaults;
+        expect(PresetFormat::read(stream.getData(), stream.getDataSize(), values), "old session is read");
+        expect(values[0] == 6.5f && values[3] == -4.5f, "old session values");
+        expect(values[1] == defaults[1] && std::equal(values.begin() + 4, values.end(), defaults.begin() + 4), "old session keeps defaults");
+    }
+
+    {
+        //forward: a newer preset with more values gives us ours, the rest stay at their defaults
+        //when it has fewer, and the stream still ends up past it
+        std::vector<float> stored (PresetFormat::numParameters + 2, 0.25f);
+        auto data = makePreset(PresetFormat::currentVersion + 1, stored);
+        data.append("TAIL", 4);
+
+        auto values = defaults;
+        juce::MemoryInputStream stream (data, false);
+        expect(PresetFormat::read(stream, values), "newer preset is read");
+        expect(std::all_of(values.begin(), values.end(), [] (float value) { return value == 0.25f; }), "newer preset values");
+
+        char tail[4] = {};
+        expect(stream.read(tail, 4) == 4 && std::memcmp(tail, "TAIL", 4) == 0, "newer preset skips what it added");
+
+        values = defaults;
+        auto shortData = makePreset(PresetFormat::currentVersion + 1, { 10.0f });
+        expect(PresetFormat::read(shortData.getData(), shortData.getSize(), values), "short newer preset is read");
+        expect(values[0] == 10.0f && std::equal(values.begin() + 1, values.end(), defaults.begin() + 1), "short newer preset keeps defaults");
+    }
+
+    {
+        //version 0 is only ever a ValueTree, a header claiming it is refused and nothing is overwritten
+        auto values = defaults;
+        auto data = makePreset(0, { 10.0f, 20.0f });
+        expect(! PresetFormat::read(data.getData(), data.getSize(), values), "version 0 header is refused");
+        expect(values == defaults, "refused preset leaves values alone");
+
+        //as is a preset cut short
+        auto truncated = makePreset(1, { 10.0f, 20.0f });
+        truncated.setSize(truncated.getSize() - 2);
+        expect(! PresetFormat::read(truncated.getData(), truncated.getSize(), values) && values == defaults, "truncated preset is refused");
+    }
+
+    {
+        //banks follow the same rule
+        const auto file = juce::File::createTempFile(".lfbank");
+
+        auto written = defaults;
+        written[0] = 7.0f;
+
+        auto writeBank = [&] (int version, bool withTrailer) {
+            juce::MemoryOutputStream stream;
+            stream.write("LFBK", 4);
+            stream.writeShort((short) version);
+            stream.writeShort(1);
+            stream.writeByte(4);
+            stream.write("Test", 4);
+            PresetFormat::write(written, stream);
+
+            //what a newer bank might add after its presets
+            if (withTrailer)
+                stream.write("MORE", 4);
+
+            file.replaceWithData(stream.getData(), stream.getDataSize());
+        };
+
+        writeBank(1, false);
+        auto bank = PresetBank::load(file, defaults);
+        expect(bank != nullptr && bank->size() == 1 && (*bank)[0].name == "Test" && (*bank)[0].values == written, "current bank is read");
+
+        writeBank(2, true);
+        bank = PresetBank::load(file, defaults);
+        expect(bank != nullptr && bank->size() == 1 && (*bank)[0].values == written, "newer bank is read");
+
+        writeBank(0, false);
+        expect(PresetBank::load(file, defaults) == nullptr, "version 0 bank is refused");
+
+        file.deleteFile();
+    }
+
+    if (failures > 0) {
+        std::printf("PresetFormatTests: %d failed\n", failures);
+        return 1;
+        }
+
+    std::puts("PresetFormatTests: passed");
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    RackInstanceBenchmark.cpp
+
+    N instances of the plugin against one instance of the rack with N
+    chains, for N up to the rack's chain count: each LadderFilterAudioProcessor
+    processes its own stereo buffer block after block, as a host would run
+    N inserts, and the rack processes one buffer with its first N buses
+    enabled and the rest off. Both sides go through processBlock with the
+    same drive, cutoff, resonance and trim per chain, so parameter reads,
+    chunking and bus handling are timed along with the DSP. The host's own
+    cost per instance comes on top of the separate instances.
+
+    RackBenchmark in LadderCore times the DSP chains alone.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/RackProcessor.h"
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 2000;
+
+    //a different cutoff and drive per chain, so no two chains settle the same way
+    struct ChainValues { float drive, cutoff, resonance, trim; };
+
+    ChainValues getChainValues(int chain)
+    {
+        return { 2.0f + 0.5f * (float) chain, 300.0f * (float) (chain + 1), 0.6f, -3.0f };
+    }
+
+    void set(juce::AudioProcessorValueTreeState& state, const juce::String& parameterId, float value)
+    {
+        auto* parameter = state.getParameter(parameterId);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+            for (int i = 0; i < buffer.getNumSamples(); i++)
+                buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+    }
+
+    //milliseconds for numBlocks, with the input refilled from a copy before every block
+    template <typename Process>
+    double timeBlocks(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& buffer, Process&& process)
+    {
+        std::chrono::duration<double, std::milli> elapsed {};
+
+        for (int block = 0; block < numBlocks; block++) {
+            buffer.makeCopyOf(input, true);
+            const auto start = std::chrono::steady_clock::now();
+            process(buffer);
+            elapsed += std::chrono::steady_clock::now() - start;
+            }
+
+        return elapsed.count();
+    }
+
+    double timeInstances(int numChains)
+    {
+        std::vector<std::unique_ptr<LadderFilterAudioProcessor>> instances;
+        std::vector<juce::AudioBuffer<float>> inputs, buffers;
+        juce::Random random (1);
+        juce::MidiBuffer midi;
+
+        for (int chain = 0; chain < numChains; chain++) {
+            instances.push_back(std::make_unique<LadderFilterAudioProcessor>());
+            auto& instance = *instances.back();
+            const auto values = getChainValues(chain);
+            set(instance.treeState, driveSliderId, values.drive);
+            set(instance.treeState, cutoffSliderId, values.cutoff);
+            set(instance.treeState, resoDelaySliderId, values.resonance);
+            set(instance.treeState, trimSliderId, values.trim);
+            instance.prepareToPlay(sampleRate, blockSize);
+
+            inputs.emplace_back(juce::jmax(instance.getTotalNumInputChannels(), instance.getTotalNumOutputChannels()), blockSize);
+            fillNoise(inputs.back(), random);
+            buffers.emplace_back();
+            }
+
+        //one block of every instance in turn, the way a host runs a chain of inserts
+        std::chrono::duration<double, std::milli> elapsed {};
+
+        for (int block = 0; block < numBlocks; block++) {
+            for (size_t i = 0; i < instances.size(); i++) {
+                buffers[i].makeCopyOf(inputs[i], true);
+                const auto start = std::chrono::steady_clock::now();
+                instances[i]->processBlock(buffers[i], midi);
+                elapsed += std::chrono::steady_clock::now() - start;
+                }
+            }
+
+        return elapsed.count();
+    }
+
+    double timeRack(int numChains)
+    {
+        LadderRackAudioProcessor rack;
+        auto layout = rack.getBusesLayout();
+
+        for (int chain = 0; chain < LadderRackAudioProcessor::numChains; chain++) {
+            const auto channels = chain < numChains ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::disabled();
+            layout.inputBuses.getReference(chain) = channels;
+            layout.outputBuses.getReference(chain) = channels;
+            }
+
+        if (! rack.setBusesLayout(layout))
+            return -1.0;
+
+        for (int chain = 0; chain < numChains; chain++) {
+            const auto values = getChainValues(chain);
+            set(rack.treeState, LadderRackAudioProcessor::getChainParameterId(chain, driveSliderId), values.drive);
+            set(rack.treeState, LadderRackAudioProcessor::getChainParameterId(chain, cutoffSliderId), values.cutoff);
+            set(rack.treeState, LadderRackAudioProcessor::getChainParameterId(chain, resoDelaySliderId), values.resonance);
+            set(rack.treeState, LadderRackAudioProcessor::getChainParameterId(chain, trimSliderId), values.trim);
+            }
+
+        rack.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> input (juce::jmax(rack.getTotalNumInputChannels(), rack.getTotalNumOutputChannels()), blockSize), buffer;
+        juce::Random random (1);
+        juce::MidiBuffer midi;
+        fillNoise(input, random);
+
+        return timeBlocks(input, buffer, [&] (juce::AudioBuffer<float>& block) { rack.processBlock(block, midi); });
+    }
+}
+
+int main()
+{
+    //a message manager exists, but nothing ever runs its loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto audioMs = numBlocks * blockSize / sampleRate * 1000.0;
+    std::printf("%d blocks of %d samples at %g Hz (%.0f ms of audio), ms in total\n", numBlocks, blockSize, sampleRate, audioMs);
+    std::printf("  %-8s %12s %12s %10s\n", "chains", "instances", "rack", "speedup");
+
+    for (int numChains = 1; numChains <= LadderRackAudioProcessor::numChains; numChains *= 2) {
+        const auto instances = timeInstances(numChains);
+        const auto rack = timeRack(numChains);
+
+        if (rack < 0.0) {
+            std::printf("RackInstanceBenchmark: the rack refused %d stereo chains\n", numChains);
+            return 1;
+            }
+
+        std::printf("  %-8d %12.2f %12.2f %9.2fx\n", numChains, instances, rack, instances / rack);
+        }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    SessionLoadTests.cpp
+
+    200 instances of the plugin loading one saved session the way a host
+    does: construct, setStateInformation, then prepareToPlay and a first
+    processBlock, all on one thread with no message loop running. Every
+    instance must have the saved values in place by its first block.
+    Prints the time each step took, in total and per instance.
+
+    setStateInformation only queues the decode on the shared workers, so
+    its time is the host thread's cost; prepareToPlay waits for whatever
+    hasn't been decoded yet. "setState to first block" is the figure to
+    compare with a decode on the host's thread.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    constexpr int numInstances = 200;
+
+    struct SavedValue { const char* parameterId; float value; };
+    const SavedValue savedValues[] = { { driveSliderId, 6.5f }, { cutoffSliderId, 3200.0f }, { resoDelaySliderId, 0.8f }, { trimSliderId, -4.5f } };
+
+    template <typename Step>
+    double timeMilliseconds(Step&& step)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        step();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    void printStep(const char* name, double milliseconds)
+    {
+        std::printf("  %-30s %9.2f ms %9.3f ms\n", name, milliseconds, milliseconds / numInstances);
+    }
+}
+
+int main()
+{
+    //a message manager exists, but nothing ever runs its loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::MemoryBlock session;
+
+    {
+        LadderFilterAudioProcessor source;
+
+        for (const auto& saved : savedValues) {
+            auto* parameter = source.treeState.getParameter(saved.parameterId);
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(saved.value));
+            }
+
+        source.getStateInformation(session);
+    }
+
+    std::vector<std::unique_ptr<LadderFilterAudioProcessor>> instances;
+    juce::AudioBuffer<float> buffer (2, 512);
+    juce::MidiBuffer midi;
+
+    const auto constructing = timeMilliseconds([&] {
+        for (int i = 0; i < numInstances; i++)
+            instances.push_back(std::make_unique<LadderFilterAudioProcessor>());
+    });
+
+    const auto restoring = timeMilliseconds([&] {
+        for (auto& instance : instances)
+            instance->setStateInformation(session.getData(), (int) session.getSize());
+    });
+
+    const auto firstBlock = timeMilliseconds([&] {
+        for (auto& instance : instances) {
+            instance->prepareToPlay(48000.0, buffer.getNumSamples());
+            buffer.clear();
+            instance->processBlock(buffer, midi);
+            }
+    });
+
+    int failures = 0;
+
+    for (auto& instance : instances)
+        for (const auto& saved : savedValues)
+            if (std::abs(instance->treeState.getRawParameterValue(saved.parameterId)->load() - saved.value) > 1.0e-3f)
+                failures++;
+
+    const auto destroying = timeMilliseconds([&] { instances.clear(); });
+
+    std::printf("%d instances, ms in total and per instance\n", numInstances);
+    printStep("construct", constructing);
+    printStep("setStateInformation", restoring);
+    printStep("prepareToPlay + first block", firstBlock);
+    printStep("setState to first block", restoring + firstBlock);
+    printStep("destroy", destroying);
+
+    if (failures > 0) {
+        std::printf("SessionLoadTests: %d saved values missing at the first block\n", failures);
+        return 1;
+        }
+
+    std::puts("SessionLoadTests: passed");
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    SnapshotMorphTests.cpp
+
+    Snapshots restored from a session tree: every value is clamped to the
+    range it was given, and missing or non-finite values come from the
+    session. Chunks of every parameter and the first four-value chunks
+    both read back, and the morph moves each parameter by its own rule.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include <cstdio>
+
+int main()
+{
+    int failures = 0;
+
+    auto expect = [&failures] (bool condition, const char* what) {
+        if (! condition) {
+            std::printf("  failed: %s\n", what);
+            failures++;
+            }
+    };
+
+    auto index = [] (const char* parameterId) { return (size_t) PresetFormat::indexOf(parameterId); };
+
+    Snapshot lowest, highest, session;
+    lowest.fill(-1.0f);
+    highest.fill(1000.0f);
+    session.fill(0.5f);
+    lowest[index(cutoffSliderId)] = 20.0f;
+    highest[index(cutoffSliderId)] = 20000.0f;
+
+    SnapshotMorph::Interpolations interpolations;
+    interpolations.fill(SnapshotMorph::Interpolation::linear);
+    interpolations[index(cutoffSliderId)] = SnapshotMorph::Interpolation::logarithmic;
+    interpolations[index(filterModeId)] = SnapshotMorph::Interpolation::step;
+    interpolations[index(morphSliderId)] = SnapshotMorph::Interpolation::none;
+
+    auto makeSlot = [] (juce::var drive, juce::var cutoff, juce::var mode) {
+        return juce::ValueTree ("SLOT", {{ driveSliderId, drive }, { cutoffSliderId, cutoff }, { filterModeId, mode }});
+    };
+
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto infinity = std::numeric_limits<double>::infinity();
+
+    juce::ValueTree tree (SnapshotMorph::getTreeType());
+    tree.appendChild(makeSlot(4.0, 1000.0, 3.0), nullptr);
+    tree.appendChild(makeSlot(1.0e6, 1.0e9, 1.0e6), nullptr);
+    tree.appendChild(makeSlot(-5.0, -100.0, -10.0), nullptr);
+    tree.appendChild(makeSlot(nan, infinity, -infinity), nullptr);
+
+    SnapshotMorph snapshots (session, interpolations);
+    snapshots.restore(tree, lowest, highest, session);
+
+    expect(snapshots.get(0)[index(driveSliderId)] == 4.0f && snapshots.get(0)[index(cutoffSliderId)] == 1000.0f, "in-range slot is kept");
+    expect(snapshots.get(0)[index(lfoRateId)] == 0.5f, "a value the slot doesn't hold comes from the session");
+    expect(snapshots.get(1)[index(driveSliderId)] == 1000.0f && snapshots.get(1)[index(cutoffSliderId)] == 20000.0f, "slot above the ranges is clamped");
+    expect(snapshots.get(2)[index(driveSliderId)] == -1.0f && snapshots.get(2)[index(cutoffSliderId)] == 20.0f, "slot below the ranges is clamped");
+    expect(snapshots.get(3)[index(driveSliderId)] == 0.5f && snapshots.get(3)[index(filterModeId)] == 0.5f, "non-finite values come from the session");
+
+    //every parameter round trips through the chunk
+    {
+        Snapshot stored = session;
+        stored[index(sideTrimId)] = 12.0f;
+        snapshots.store(0, stored);
+
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream (block, false);
+            snapshots.write(stream);
+        }
+
+        juce::MemoryInputStream stream (block, false);
+        const auto read = SnapshotMorph::read(stream);
+        SnapshotMorph restored (session, interpolations);
+        restored.restore(read, lowest, highest, session);
+        expect(restored.get(0) == stored, "a chunk reads back every parameter");
+    }
+
+    //the first chunks held drive, cutoff, resonance and trim only
+    {
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream (block, false);
+            stream.write("LFSN", 4);
+            stream.writeShort(1);
+
+            for (auto value : { 2.0f, 500.0f, 0.25f, -6.0f })
+                stream.writeFloat(value);
+        }
+
+        juce::MemoryInputStream stream (block, false);
+        const auto read = SnapshotMorph::read(stream);
+        SnapshotMorph restored (session, interpolations);
+        restored.restore(read, lowest, highest, session);
+
+        const auto slot = restored.get(0);
+        expect(slot[index(driveSliderId)] == 2.0f && slot[index(cutoffSliderId)] == 500.0f
+               && slot[index(resoDelaySliderId)] == 0.25f && slot[index(trimSliderId)] == -6.0f, "a four-value chunk still reads");
+        expect(slot[index(filterModeId)] == 0.5f, "a four-value chunk leaves the rest at the session's values");
+    }
+
+    //linear, log, step and untouched, halfway and either side of it
+    {
+        Snapshot from = session, to = session;
+        from[index(driveSliderId)] = 0.0f;
+        to[index(driveSliderId)] = 10.0f;
+        from[index(cutoffSliderId)] = 100.0f;
+        to[index(cutoffSliderId)] = 10000.0f;
+        from[index(filterModeId)] = 0.0f;
+        to[index(filterModeId)] = 4.0f;
+        snapshots.store(0, from);
+        snapshots.store(1, to);
+
+        Snapshot values = session;
+        values[index(morphSliderId)] = 0.25f;
+        snapshots.morph(0, 1, 0.5f, values);
+        expect(values[index(driveSliderId)] == 5.0f, "linear values are interpolated");
+        expect(std::abs(values[index(cutoffSliderId)] - 1000.0f) < 0.1f, "frequencies are interpolated in octaves");
+        expect(values[index(filterModeId)] == 4.0f, "choices switch at the midpoint");
+        expect(values[index(morphSliderId)] == 0.25f, "values marked none are left alone");
+
+        snapshots.morph(0, 1, 0.49f, values);
+        expect(values[index(filterModeId)] == 0.0f, "choices hold before the midpoint");
+    }
+
+    //the morph stays finite whichever slots it runs between
+    for (int from = 0; from < SnapshotMorph::numSlots; from++)
+        for (int to = 0; to < SnapshotMorph::numSlots; to++) {
+            Snapshot morphed = session;
+            snapshots.morph(from, to, 0.5f, morphed);
+            expect(std::all_of(morphed.begin(), morphed.end(), [] (float value) { return std::isfinite(value); }), "morph is finite");
+            }
+
+    if (failures > 0) {
+        std::printf("SnapshotMorphTests: %d failed\n", failures);
+        return 1;
+        }
+
+    std::puts("SnapshotMorphTests: passed");
+    return 0;
+}
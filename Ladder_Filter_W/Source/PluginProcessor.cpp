@@ -113,15 +113,7 @@ void Ladder_Filter_WAudioProcessor::changeProgramName(int index, const juce::Str
 //==============================================================================
 void Ladder_Filter_WAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.sampleRate = sampleRate;
-    spec.numChannels = getTotalNumOutputChannels();
-
-    ladderProcessor.prepare(spec);
-    ladderProcessor.setDrive(1.0);
-
-    trimProcessor.prepare(spec);
+    engine.prepare(sampleRate, getTotalNumOutputChannels());
 }
 
 void Ladder_Filter_WAudioProcessor::releaseResources()
@@ -165,37 +157,12 @@ void Ladder_Filter_WAudioProcessor::processBlock(juce::AudioBuffer<float>& buffe
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    auto* rawDrive = treeState.getRawParameterValue(driveSliderId);
-    auto* rawCutoff = treeState.getRawParameterValue(cutoffSliderId);
-    auto* rawReso = treeState.getRawParameterValue(resoDelaySliderId);
-    auto* rawTrim = treeState.getRawParameterValue(trimSliderId);
-
-    for (int channel = 0; channel < totalNumInputChannels; ++channel) {
-        auto* outputData = buffer.getWritePointer(channel);
-        auto* inputData = buffer.getReadPointer(channel);
-
-        for (int sample = 0; sample < buffer.getNumSamples(); sample++) {
-            outputData[sample] = softClip(inputData[sample], *rawDrive * 5);
-        }
-    }
-
-    juce::dsp::AudioBlock<float> audioBlock{ buffer };
-
-    ladderProcessor.setCutoffFrequencyHz(*rawCutoff);
-    ladderProcessor.setResonance(*rawReso);
-
-    trimProcessor.setGainDecibels(*rawTrim);
-
-    ladderProcessor.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
-    trimProcessor.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
-}
-
-float Ladder_Filter_WAudioProcessor::softClip(const float& input, const float& drive) {
-
-    //1.5f to account for drop in gain from the saturation initial state
-    //pow(10, (-1 * drive) * 0.04f) to account for the increase in gain when the drive goes up
+    engine.setParameter(LadderEngine::Parameter::drive, *treeState.getRawParameterValue(driveSliderId));
+    engine.setParameter(LadderEngine::Parameter::cutoff, *treeState.getRawParameterValue(cutoffSliderId));
+    engine.setParameter(LadderEngine::Parameter::resonance, *treeState.getRawParameterValue(resoDelaySliderId));
+    engine.setParameter(LadderEngine::Parameter::trim, *treeState.getRawParameterValue(trimSliderId));
 
-    return piDivisor * atan(pow(10, drive * 0.05f) * input) * 1.5f * pow(10, (-1 * drive) * 0.04f);
+    engine.process(buffer.getArrayOfWritePointers(), totalNumInputChannels, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../LadderCore/Source/LadderEngine.h"
 
 #define driveSliderId "drive"
 #define driveSliderName "Drive"
@@ -65,16 +66,13 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    float softClip(const float& input, const float& drive);
-
     juce::AudioProcessorValueTreeState treeState;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
 private:
 
-    const float piDivisor = 2 / 3.14;
-    juce::dsp::LadderFilter<float> ladderProcessor;
-    juce::dsp::Gain<float> trimProcessor;
+    //drive, ladder and trim, shared with the LadderFilter project through LadderCore
+    LadderEngine engine;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Ladder_Filter_WAudioProcessor)